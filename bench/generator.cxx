@@ -0,0 +1,80 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <array>
+#include <chrono>
+
+#include "Generator.hxx"
+#include "ThreadPool.hxx"
+
+namespace {
+struct Preset {
+    const char* name;
+    int rows;
+    int cols;
+    int mines;
+};
+}
+
+/*
+* Generates no-guess boards from fixed base seeds on every hardware thread and
+* reports how many candidates the solver checks per second and what share of
+* them it can clear.
+*/
+int main(int argc, char* argv[])
+{
+    const int boards = argc > 1 ? std::atoi(argv[1]) : 20;
+    constexpr std::array<Preset, 3> presets{{
+        {"Beginner", 9, 9, 10},
+        {"Intermediate", 16, 16, 40},
+        {"Advanced", 16, 30, 99}
+    }};
+
+    using namespace termmine;
+    ThreadPool pool;
+    std::printf("Threads: %u\n", pool.size());
+    std::printf("%-14s %8s %10s %12s %10s %12s\n", "Difficulty", "Boards",
+                "Tried", "Tried/s", "Solvable", "ms/board");
+    for (const auto& preset : presets) {
+        NoGuessGenerator generator{pool};
+        for (int i = 0; i < boards; ++i) {
+            generator.find_seed(preset.rows, preset.cols, preset.mines,
+                                static_cast<std::uint_fast64_t>(i));
+        }
+
+        const auto& stats = generator.stats();
+        const double seconds = std::chrono::duration<double>(stats.elapsed)
+            .count();
+        std::printf("%-14s %8d %10llu %12.0f %9.2f%% %12.2f\n", preset.name,
+                    boards, static_cast<unsigned long long>(stats.tried),
+                    stats.tried / seconds, 100.0 * stats.solvable / stats.tried,
+                    1000 * seconds / boards);
+    }
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ncurses.h>
+
+#include "Game.hxx"
+#include "play.hxx"
+
+namespace {
+using namespace termmine;
+
+struct Result {
+    std::string name;
+    std::string params;
+    long long ops;
+    double mean_ns;
+    double min_ns;
+};
+
+int reps = 20;
+std::vector<Result> results;
+volatile int sink;
+
+std::string size_params(const int rows, const int cols, const int mines)
+{
+    return std::to_string(rows) + 'x' + std::to_string(cols) + '/'
+        + std::to_string(mines);
+}
+
+/*
+* Times batches of ops calls of op(state, i), with a fresh state from
+* prepare() for each batch that isn't timed, and records the mean and best
+* time per call.
+*/
+template <typename Prepare, typename Op>
+void measure(std::string name, std::string params, const int ops,
+             Prepare&& prepare, Op&& op)
+{
+    double total = 0;
+    double best = 1e300;
+    for (int rep = 0; rep < reps; ++rep) {
+        auto state = prepare();
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ops; ++i)
+            op(state, i);
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / ops;
+        total += ns;
+        best = std::min(best, ns);
+    }
+    results.push_back({std::move(name), std::move(params),
+                       static_cast<long long>(ops) * reps, total / reps,
+                       best});
+}
+
+std::vector<Game> copies(const Game& game, const int count)
+{
+    return std::vector<Game>(count, game);
+}
+
+// The first cell matching pred in row-major order
+template <typename Pred>
+std::pair<int, int> find_cell(const Game& game, Pred&& pred)
+{
+    for (int i = 0; i < game.rows(); ++i) {
+        for (int j = 0; j < game.cols(); ++j) {
+            if (pred(i, j))
+                return {i, j};
+        }
+    }
+    return {0, 0};
+}
+
+void bench_construct(const std::uint_fast64_t seed)
+{
+    constexpr int sizes[][3]{
+        {9, 9, 10}, {16, 16, 40}, {16, 30, 99},
+        {100, 100, 1000}, {100, 100, 2000}, {100, 100, 3000}
+    };
+    for (const auto& [rows, cols, mines] : sizes) {
+        measure("construct", size_params(rows, cols, mines),
+                std::max(10, 100000 / (rows * cols)),
+                [] { return 0; },
+                [&, rows = rows, cols = cols, mines = mines](int, int i) {
+                    const Game game{rows, cols, mines, seed + i};
+                    sink = game.board()[0][0];
+                });
+    }
+}
+
+void bench_flood(const std::uint_fast64_t seed)
+{
+    constexpr int sizes[][3]{{64, 64, 0}, {128, 128, 0}, {100, 100, 500}};
+    for (const auto& [rows, cols, mines] : sizes) {
+        const Game game{rows, cols, mines, seed};
+        // The flood fill runs from a cell with no mines around it
+        const auto [row, col] = find_cell(game, [&game](int i, int j) {
+            return !game.has_mine(i, j) && game.num_adj_mines(i, j) == 0;
+        });
+        constexpr int ops = 20;
+        measure("open_cell_flood", size_params(rows, cols, mines), ops,
+                [&] { return copies(game, ops); },
+                [row = row, col = col](auto& games, const int i) {
+                    games[i].open_cell(row, col);
+                });
+    }
+}
+
+void bench_chord(const std::uint_fast64_t seed)
+{
+    constexpr int rows = 16;
+    constexpr int cols = 30;
+    constexpr int mines = 99;
+    Game game{rows, cols, mines, seed};
+
+    // A number with safe neighbours, opened and with its mines flagged
+    const auto [row, col] = find_cell(game, [&game](int i, int j) {
+        return !game.has_mine(i, j) && game.num_adj_mines(i, j) > 0
+            && game.num_adj_mines(i, j) < 3;
+    });
+    game.open_cell(row, col);
+    for (int i = std::max(row - 1, 0); i <= std::min(row + 1, rows - 1); ++i) {
+        for (int j = std::max(col - 1, 0); j <= std::min(col + 1, cols - 1);
+             ++j) {
+            if (game.has_mine(i, j))
+                game.flag_cell(i, j);
+        }
+    }
+
+    constexpr int ops = 1000;
+    measure("chord_cell", size_params(rows, cols, mines), ops,
+            [&] { return copies(game, ops); },
+            [row = row, col = col](auto& games, const int i) {
+                games[i].chord_cell(row, col);
+            });
+}
+
+void bench_check_win(const std::uint_fast64_t seed)
+{
+    constexpr int rows = 16;
+    constexpr int cols = 30;
+    constexpr int mines = 99;
+    measure("check_win", size_params(rows, cols, mines), 1000000,
+            [&] {
+                Game game{rows, cols, mines, seed};
+                game.open_cell(rows / 2, cols / 2);
+                return game;
+            },
+            [](Game& game, const int i) {
+                game.check_win(i % rows, i / rows % cols);
+            });
+
+    // With every safe cell open, each call takes the winning path and
+    // autoflags the mines
+    const Game start{rows, cols, mines, seed};
+    const auto [row, col] = find_cell(start, [&start](int i, int j) {
+        return !start.has_mine(i, j);
+    });
+    measure("check_win_won", size_params(rows, cols, mines), 10000,
+            [&start, row = row, col = col] {
+                Game game{start};
+                game.open_cell(row, col);
+                for (int i = 0; i < rows; ++i) {
+                    for (int j = 0; j < cols; ++j) {
+                        if (!game.has_mine(i, j))
+                            game.open_cell(i, j);
+                    }
+                }
+                return game;
+            },
+            [row = row, col = col](Game& game, int) {
+                game.check_win(row, col);
+                sink = game.has_won();
+            });
+}
+
+/*
+* finish_board() and label_regions() are private, so they are timed through
+* the only path that reruns them after construction: a first click on a mine,
+* which moves the mine, then recounts and relabels the whole board.
+*/
+void bench_recount(const std::uint_fast64_t seed)
+{
+    constexpr int sizes[][3]{{16, 30, 99}, {100, 100, 2000}};
+    for (const auto& [rows, cols, mines] : sizes) {
+        const Game game{rows, cols, mines, seed};
+        const auto [row, col] = find_cell(game, [&game](int i, int j) {
+            return game.has_mine(i, j);
+        });
+        constexpr int ops = 20;
+        measure("first_click_recount", size_params(rows, cols, mines),
+                ops, [&] { return copies(game, ops); },
+                [row = row, col = col](auto& games, const int i) {
+                    games[i].open_cell(row, col);
+                });
+    }
+}
+
+/*
+* Renders whole frames into a virtual screen that writes to /dev/null. Every
+* frame toggles the heatmap so that each unopened cell really changes.
+*/
+void bench_update_board(const std::uint_fast64_t seed)
+{
+    std::FILE* const out = std::fopen("/dev/null", "w");
+    std::FILE* const in = std::fopen("/dev/null", "r");
+    SCREEN* const screen = out && in
+        ? newterm("xterm-256color", out, in) : nullptr;
+    if (!screen) {
+        std::fprintf(stderr, "Skipping update_board: no virtual screen\n");
+        return;
+    }
+    set_term(screen);
+    resizeterm(256, 256);
+    start_color();
+    define_colors();
+    define_glyphs(false);
+
+    constexpr int sizes[][3]{{16, 30, 99}, {50, 80, 800}};
+    for (const auto& [rows, cols, mines] : sizes) {
+        Game game{rows, cols, mines, seed};
+        game.open_cell(rows / 2, cols / 2);
+        WINDOW* const board = newwin(rows * 2 + 1, cols * 2 + 1, 3, 0);
+        BoardCache cache{make_board_cache(game)};
+        draw_board(board, game, cache);
+        const std::vector<double> no_heat;
+        const std::vector<double> heat(rows * cols, 0.3);
+
+        measure("update_board", size_params(rows, cols, mines), 200,
+                [] { return 0; },
+                [&](int, const int i) {
+                    update_board(board, game, cache, i % 2 ? heat : no_heat,
+                                 std::nullopt);
+                });
+        measure("frame", size_params(rows, cols, mines), 200,
+                [] { return 0; },
+                [&](int, const int i) {
+                    update_board(board, game, cache, i % 2 ? heat : no_heat,
+                                 std::nullopt);
+                    wnoutrefresh(board);
+                    doupdate();
+                });
+        delwin(board);
+    }
+
+    endwin();
+    delscreen(screen);
+    std::fclose(in);
+    std::fclose(out);
+}
+}
+
+/*
+* Times the engine's hot paths and the renderer on boards from a fixed seed,
+* printing the results as JSON to track regressions between releases.
+*/
+int main(int argc, char* argv[])
+{
+    reps = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+    const std::uint_fast64_t seed = argc > 2
+        ? std::strtoull(argv[2], nullptr, 10) : 1;
+
+    bench_construct(seed);
+    bench_flood(seed);
+    bench_chord(seed);
+    bench_check_win(seed);
+    bench_recount(seed);
+    bench_update_board(seed);
+
+    std::printf("{\n  \"seed\": %llu,\n  \"reps\": %d,\n  \"results\": [\n",
+                static_cast<unsigned long long>(seed), reps);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::printf("    {\"name\": \"%s\", \"params\": \"%s\", \"ops\": %lld, "
+                    "\"mean_ns\": %.1f, \"min_ns\": %.1f}%s\n",
+                    result.name.c_str(), result.params.c_str(), result.ops,
+                    result.mean_ns, result.min_ns,
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+    return 0;
+}
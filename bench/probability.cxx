@@ -0,0 +1,106 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "Game.hxx"
+#include "Probability.hxx"
+#include "Solver.hxx"
+#include "ThreadPool.hxx"
+
+/*
+* Plays seeded Advanced boards with the solver until it has to guess, then
+* times the probability engine on the resulting position.
+*/
+int main(int argc, char* argv[])
+{
+    using namespace termmine;
+    const int boards = argc > 1 ? std::atoi(argv[1]) : 1000;
+    constexpr int rows = 16;
+    constexpr int cols = 30;
+    constexpr int mines = 99;
+
+    ThreadPool pool;
+    ProbabilityEngine engine{pool, false};
+    std::vector<double> times;
+    double max_error = 0;
+    int inconsistent = 0;
+
+    for (int seed = 0; seed < boards; ++seed) {
+        Game game{rows, cols, mines, static_cast<std::uint_fast64_t>(seed)};
+        Solver solver{game, false};
+        int row = rows / 2;
+        int col = cols / 2;
+        while (true) {
+            game.open_cell(row, col);
+            game.check_win(row, col);
+            if (game.is_over())
+                break;
+
+            solver.update();
+            const auto cell = solver.next_safe();
+            if (!cell)
+                break;
+            row = cell->first;
+            col = cell->second;
+        }
+        if (game.is_over())
+            continue;
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto probs = engine.compute(game);
+        times.push_back(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+
+        // The probabilities of the unopened cells must add up to the mines
+        if (probs.empty()) {
+            ++inconsistent;
+            continue;
+        }
+        double expected = 0;
+        for (const double prob : probs)
+            expected += prob;
+        max_error = std::max(max_error, std::abs(expected - mines));
+    }
+
+    if (times.empty())
+        return 0;
+    std::sort(times.begin(), times.end());
+    double sum = 0;
+    for (const double time : times)
+        sum += time;
+    std::printf("Positions: %zu  Threads: %u\n", times.size(), pool.size());
+    std::printf("Mean: %.3f ms  p50: %.3f ms  p99: %.3f ms  Max: %.3f ms\n",
+                sum / times.size(), times[times.size() / 2],
+                times[times.size() * 99 / 100], times.back());
+    std::printf("Inconsistent: %d  Max mine total error: %g\n", inconsistent,
+                max_error);
+    return 0;
+}
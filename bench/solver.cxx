@@ -0,0 +1,100 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <array>
+#include <chrono>
+
+#include "Game.hxx"
+#include "Solver.hxx"
+
+namespace {
+struct Preset {
+    const char* name;
+    int rows;
+    int cols;
+    int mines;
+};
+}
+
+/*
+* Plays seeded boards from a first click in the middle, opening only cells the
+* solver proves safe, and reports how many boards it clears without guessing.
+*/
+int main(int argc, char* argv[])
+{
+    const int boards = argc > 1 ? std::atoi(argv[1]) : 10000;
+    constexpr std::array<Preset, 3> presets{{
+        {"Beginner", 9, 9, 10},
+        {"Intermediate", 16, 16, 40},
+        {"Advanced", 16, 30, 99}
+    }};
+
+    std::printf("%-14s %8s %8s %8s %12s %12s\n", "Difficulty", "Boards",
+                "Solved", "Errors", "Deductions", "us/board");
+    for (const auto& preset : presets) {
+        int solved = 0;
+        int errors = 0;
+        long long deductions = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int seed = 0; seed < boards; ++seed) {
+            using namespace termmine;
+            Game game{preset.rows, preset.cols, preset.mines,
+                      static_cast<std::uint_fast64_t>(seed)};
+            Solver solver{game, false};
+
+            int row = preset.rows / 2;
+            int col = preset.cols / 2;
+            while (true) {
+                game.open_cell(row, col);
+                game.check_win(row, col);
+                if (game.is_over())
+                    break;
+
+                solver.update();
+                const auto cell = solver.next_safe();
+                if (!cell)
+                    break;
+                row = cell->first;
+                col = cell->second;
+            }
+
+            solved += game.has_won();
+            errors += game.is_over() && !game.has_won();
+            deductions += solver.safe_found() + solver.mines_found();
+        }
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const double us = std::chrono::duration<double, std::micro>(elapsed)
+            .count();
+        std::printf("%-14s %8d %7.2f%% %8d %12lld %12.2f\n", preset.name,
+                    boards, 100.0 * solved / boards, errors, deductions,
+                    us / boards);
+    }
+
+    return 0;
+}
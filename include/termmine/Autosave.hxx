@@ -0,0 +1,109 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_AUTOSAVE_HXX
+#define TERMMINE_AUTOSAVE_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Game.hxx"
+#include "Replay.hxx"
+
+namespace termmine {
+// A game saved by Autosave, as its board and the moves made on it
+struct SavedGame {
+    ReplayHeader header;
+    std::vector<ReplayEvent> moves;
+
+    // Replays the moves, carrying on the timer from the last one
+    Game restore() const;
+};
+
+/*
+* Saves the game in progress so it can be resumed after a crash or a dropped
+* connection. The game loop only queues moves, and a background thread appends
+* them to a journal of checksummed records and every so often compacts all of
+* them into a checkpoint in the replay format, so the loop never waits on the
+* disk.
+*
+* The checkpoint is replaced by renaming a new one over it, and the journal
+* names how many moves came before it, so loading can always stop at the last
+* consistent move: the checkpoint's moves, then the journal's up to the first
+* torn record. Both carry a random id for the game, so a journal left over
+* from an earlier game on the same seed is never applied to a new checkpoint.
+*/
+class Autosave final {
+public:
+    // Saves into dir, where history is the moves made before this session
+    Autosave(const std::string& dir, const Game& game,
+             std::vector<ReplayEvent> history = {});
+    // Writes out any moves still queued
+    ~Autosave();
+
+    Autosave(const Autosave&) = delete;
+    Autosave& operator=(const Autosave&) = delete;
+
+    void record(Action action, int row, int col, std::int64_t time);
+    // Deletes the save once the game is over or abandoned
+    void discard();
+
+    // The game saved in dir, if any
+    static std::optional<SavedGame> load(const std::string& dir);
+    static void remove(const std::string& dir);
+
+private:
+    static constexpr std::size_t checkpoint_every = 256;
+
+    const std::string dir_;
+    const ReplayHeader header_;
+    const std::uint64_t id_;
+    // Only touched by the worker
+    std::vector<ReplayEvent> history_;
+    std::FILE* journal_ = nullptr;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<ReplayEvent> pending_; // guarded by mutex_
+    bool discard_ = false;              // guarded by mutex_
+    bool stopping_ = false;             // guarded by mutex_
+    std::thread worker_;
+
+    void work();
+    void append(const std::vector<ReplayEvent>& moves);
+    // Writes every move to a new checkpoint and starts an empty journal,
+    // returning false if the old checkpoint had to be kept
+    bool write_checkpoint();
+};
+}
+
+#endif
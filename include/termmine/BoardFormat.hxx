@@ -0,0 +1,99 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_BOARDFORMAT_HXX
+#define TERMMINE_BOARDFORMAT_HXX
+
+#include <cstdio>
+
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "Game.hxx"
+
+namespace termmine {
+/*
+* Board layouts shared with other minesweeper tools. Any number of boards can
+* follow each other in one file.
+*
+* mbf:  Minesweeper Arbiter's binary layout: a byte each for the width and
+*       height, the mine count as two big-endian bytes, then a byte each for
+*       every mine's x and y.
+* grid: One line of text per row, with * for a mine and . for a safe cell.
+*       Boards are separated by a blank line.
+* list: The width, height and mine count, then every mine's x and y, all as
+*       whitespace-separated numbers.
+*/
+enum class BoardFormat {
+    mbf,
+    grid,
+    list
+};
+
+// The format with the given name, if any
+std::optional<BoardFormat> board_format(std::string_view name) noexcept;
+
+// A board's size and its mines as row * cols + col
+struct Board {
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> mines;
+};
+
+class BadBoard final : public std::runtime_error {
+public:
+    BadBoard(const char* what) : runtime_error{what} {}
+};
+
+// Parses boards a character at a time as they are read, keeping nothing but
+// the board being built. Throws BadBoard on malformed input.
+class BoardReader final {
+public:
+    BoardReader(std::FILE* in, BoardFormat format) noexcept;
+
+    // The next board, or nothing at the end of the input
+    std::optional<Board> next();
+
+private:
+    std::FILE* const in_;
+    const BoardFormat format_;
+
+    std::optional<Board> next_mbf();
+    std::optional<Board> next_grid();
+    std::optional<Board> next_list();
+    // Reads a whitespace-separated number, or nothing at the end of input
+    std::optional<int> read_number();
+};
+
+// The game's current mine layout
+Board board_of(const Game& game);
+
+// Writes the board, throwing BadBoard if it doesn't fit the format or the
+// write fails
+void write_board(std::FILE* out, const Board& board, BoardFormat format);
+}
+
+#endif
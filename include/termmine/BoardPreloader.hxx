@@ -0,0 +1,82 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_BOARDPRELOADER_HXX
+#define TERMMINE_BOARDPRELOADER_HXX
+
+#include <cstdint>
+
+#include <future>
+#include <optional>
+
+#include "Game.hxx"
+#include "Generator.hxx"
+#include "ThreadPool.hxx"
+
+namespace termmine {
+/*
+* Builds the next board of a given size on a background thread while the
+* current one is being played, so that playing again is instant even when a
+* no-guess search takes seconds. A fixed seed gives the same board every time.
+*/
+class BoardPreloader final {
+public:
+    // If no_guess is set, boards come from the no-guess generator
+    BoardPreloader(int rows, int cols, int mines,
+                   std::optional<std::uint_fast64_t> seed, bool no_guess);
+    ~BoardPreloader();
+
+    BoardPreloader(const BoardPreloader&) = delete;
+    BoardPreloader& operator=(const BoardPreloader&) = delete;
+
+    struct Deal {
+        Game game;
+        // Unset if the no-guess search gave up and the board is an ordinary
+        // one that may need guessing
+        bool no_guess;
+    };
+
+    bool ready() const;
+    // Hands over the next board, waiting only if it isn't ready yet, and
+    // starts on the one after it
+    Deal take();
+
+private:
+    const int rows_;
+    const int cols_;
+    const int mines_;
+    const std::optional<std::uint_fast64_t> seed_;
+    const bool no_guess_;
+
+    // Only started for no-guess boards
+    std::optional<ThreadPool> pool_;
+    std::optional<NoGuessGenerator> generator_;
+
+    std::future<Deal> next_;
+
+    Deal build();
+};
+}
+
+#endif
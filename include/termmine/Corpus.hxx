@@ -0,0 +1,99 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_CORPUS_HXX
+#define TERMMINE_CORPUS_HXX
+
+#include <cstddef>
+#include <cstdint>
+
+#include <stdexcept>
+#include <vector>
+
+namespace termmine {
+/*
+* Corpus files hold many boards of one size, packed so that a mapped file can
+* be read in place. A 64-byte header has the magic "TMBC", a 16-bit version
+* and flags, then 32-bit rows, cols, mines and record size, the 64-bit board
+* count, and a checksum of the bytes before it. Each record follows as the
+* board's 64-bit seed and then its mines as a bitset of 64-bit words, bit i
+* set if cell i (as row * cols + col) has a mine. Every field is
+* little-endian and every record 8-byte aligned.
+*
+* Boards are laid out as Game lays them from their seed, before the first
+* open can move a mine.
+*/
+struct CorpusHeader {
+    int rows;
+    int cols;
+    int mines;
+    // Boards from the no-guess generator, solvable from their start cell
+    bool no_guess;
+    std::uint64_t boards;
+};
+
+class BadCorpus final : public std::runtime_error {
+public:
+    BadCorpus(const char* what) : runtime_error{what} {}
+};
+
+inline constexpr std::size_t corpus_header_size = 64;
+
+// Size of each board's record
+std::size_t corpus_record_size(int rows, int cols) noexcept;
+// Size of a whole corpus file, or SIZE_MAX if it can't fit in memory
+std::size_t corpus_file_size(const CorpusHeader& header) noexcept;
+
+void write_corpus_header(unsigned char* out,
+                         const CorpusHeader& header) noexcept;
+// Writes a board's seed and mines, as row * cols + col, into its record
+void write_corpus_board(unsigned char* out, const CorpusHeader& header,
+                        std::uint_fast64_t seed,
+                        const std::vector<int>& mine_cells) noexcept;
+
+// Reads boards straight out of a corpus in memory, which must outlive the
+// view. Only the header is checked, so any board is a few loads away.
+class CorpusView final {
+public:
+    // Throws BadCorpus if the header is malformed or the data too short
+    CorpusView(const unsigned char* data, std::size_t size);
+
+    const CorpusHeader& header() const noexcept;
+    std::uint64_t size() const noexcept;
+
+    std::uint_fast64_t seed(std::uint64_t board) const noexcept;
+    bool has_mine(std::uint64_t board, int row, int col) const noexcept;
+    // The board's mine bitset, of (rows * cols + 63) / 64 words
+    const unsigned char* mine_bits(std::uint64_t board) const noexcept;
+
+private:
+    const unsigned char* const records_;
+    CorpusHeader header_;
+    std::size_t record_size_;
+
+    const unsigned char* record(std::uint64_t board) const noexcept;
+};
+}
+
+#endif
@@ -40,18 +40,44 @@ class Game final {
 public:
     Game(int rows, int cols, int mines) noexcept;
     Game(int rows, int cols, int mines, std::uint_fast64_t seed) noexcept;
+    // Lays mines on the given cells, as row * cols + col, each at most once
+    // and leaving at least one safe cell. Such games have a seed of 0.
+    Game(int rows, int cols, const std::vector<int>& mine_cells) noexcept;
+
+    // The cells, as row * cols + col, a game with the seed lays its mines on
+    // before its first open
+    static std::vector<int> mine_layout(int rows, int cols, int mines,
+                                        std::uint_fast64_t seed);
+    // Same, reusing cells' storage for callers that lay out many boards
+    static void mine_layout(int rows, int cols, int mines,
+                            std::uint_fast64_t seed, std::vector<int>& cells);
 
     int rows() const noexcept;
     int cols() const noexcept;
     int mines() const noexcept;
     const std::vector<std::vector<unsigned char>>& board() const noexcept;
     std::chrono::milliseconds::rep get_time() const noexcept;
+    // Whether the first open has started the timer
+    bool timer_started() const noexcept;
+    // Carries on the timer from time, for a game restored by replaying it
+    void resume_time(std::chrono::milliseconds::rep time) noexcept;
     std::uint_fast64_t seed() const noexcept;
 
+    // Cells (as row * cols + col) opened, flagged or unflagged, oldest first
+    const std::vector<int>& changes() const noexcept;
+
     bool is_over() const noexcept;
     bool has_won() const noexcept;
     int flags() const noexcept;
 
+    // Minimum number of clicks to clear the board, known as its 3BV. The
+    // first open may move a mine, so this is only final after it.
+    int bbbv() const noexcept;
+    // How much of the 3BV the cells opened so far account for
+    int solved_bbbv() const noexcept;
+    // Opens, chords, flags and marks made by the player
+    int clicks() const noexcept;
+
     // Pass in coordinates of just-opened cell
     void check_win(int row, int col) noexcept;
 
@@ -92,11 +118,41 @@ private:
     bool won_ = false;
     int cells_flagged_ = 0;
     int open_cells_ = 0;
+    std::vector<int> changes_;
+
+    // Regions of connected zeros, labeled when the board is generated. Each
+    // lists its cells and then its border in region_cells_, from
+    // region_first_[region] up to region_first_[region + 1].
+    int regions_ = 0;
+    std::vector<int> region_first_;
+    std::vector<int> region_cells_;
+    // Flagged or marked cells in each region, which a flood can't pass
+    std::vector<int> region_blocked_;
+
+    // The 3BV click each safe cell belongs to: its region for zeros, which
+    // opens along with its border, and one each for numbers outside every
+    // border. Border numbers and mines have none.
+    std::vector<int> click_of_;
+    std::vector<char> click_solved_;
+    // Cells a flood has yet to open, kept to reuse its storage
+    std::vector<int> flood_;
+    int bbbv_ = 0;
+    int solved_bbbv_ = 0;
+    int clicks_ = 0;
 
     void toggle_mine(int row, int col) noexcept;
+    // Counts adjacent mines and labels the regions once the mines are laid
+    void finish_board() noexcept;
+    void toggle_flag(int row, int col) noexcept;
+    // Counts a cell's change of flag or mark against its region
+    void update_blocked(int row, int col, bool was_blocked) noexcept;
+    // Labels the zero regions and 3BV clicks, in time linear in the board's
+    // size
+    void label_regions();
+    // Opens a cell and floods out from it
+    void open_region(int row, int col);
     std::vector<std::pair<int, int>> adjacent_cells(int row, int col)
         const noexcept;
-    void set_adj_mines_count(int row, int col) noexcept;
     std::pair<int, int> first_open_cell() const;
 };
 
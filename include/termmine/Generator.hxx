@@ -0,0 +1,90 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_GENERATOR_HXX
+#define TERMMINE_GENERATOR_HXX
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <utility>
+
+#include "Game.hxx"
+#include "ThreadPool.hxx"
+
+namespace termmine {
+// Whether opening the cells the solver proves safe, starting with (row, col),
+// clears the board
+bool solvable_without_guessing(Game game, int row, int col);
+
+/*
+* Generates boards that can be cleared without guessing from a first click in
+* the middle. Candidate layouts come from seeds derived from a base seed and
+* are checked by the solver in parallel batches. The lowest accepted candidate
+* wins, so the result doesn't depend on the number of threads, and the
+* accepted seed alone reproduces the board with the plain Game constructor.
+*/
+class NoGuessGenerator final {
+public:
+    struct Stats {
+        // Candidates checked by the solver, and how many of them it could
+        // clear. Those after an accepted one may be skipped, but whether
+        // one is has nothing to do with its own layout.
+        std::uint64_t tried = 0;
+        std::uint64_t solvable = 0;
+        // Searches that found a seed
+        std::uint64_t accepted = 0;
+        std::chrono::steady_clock::duration elapsed{};
+    };
+
+    explicit NoGuessGenerator(ThreadPool& pool,
+                              std::size_t max_tries = 1'000'000) noexcept;
+
+    // The first solvable seed derived from base, or nothing if none was
+    // found within the try limit or the search was cancelled
+    std::optional<std::uint_fast64_t> find_seed(int rows, int cols, int mines,
+                                                std::uint_fast64_t base);
+    // Stops the current search and any later ones, from any thread
+    void cancel() noexcept;
+
+    // Candidate i of base. Candidate 0 is base itself, so searching from an
+    // accepted seed accepts it again straight away.
+    static std::uint_fast64_t derive_seed(std::uint_fast64_t base,
+                                          std::size_t i) noexcept;
+    static std::pair<int, int> start_cell(int rows, int cols) noexcept;
+
+    const Stats& stats() const noexcept;
+
+private:
+    ThreadPool& pool_;
+    const std::size_t max_tries_;
+    std::atomic<bool> cancelled_{false};
+    Stats stats_;
+};
+}
+
+#endif
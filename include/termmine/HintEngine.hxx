@@ -0,0 +1,79 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_HINTENGINE_HXX
+#define TERMMINE_HINTENGINE_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "Game.hxx"
+#include "ProbabilityWorker.hxx"
+#include "Solver.hxx"
+
+namespace termmine {
+struct Hint {
+    int row;
+    int col;
+    // Proven safe rather than only the least likely to be a mine
+    bool safe;
+};
+
+/*
+* Suggests the next cell to open. A cell the solver proves safe is always
+* preferred. Otherwise the exact probabilities are waited on for at most the
+* budget, after which a quick estimate is shown instead and replaced once the
+* exact result arrives, so asking for a hint never stalls the game.
+*/
+class HintEngine final {
+public:
+    HintEngine(const Game& game, std::chrono::milliseconds budget);
+
+    std::optional<Hint> request(ProbabilityWorker& worker);
+    // Swaps an estimated hint for an exact one once it is ready, returning
+    // whether the hint changed
+    bool refine(ProbabilityWorker& worker);
+    // Whether an estimated hint is still waiting on the exact probabilities
+    bool refining() const noexcept;
+
+    // The last hint, unless the game has changed since it was given
+    std::optional<Hint> current() const noexcept;
+
+private:
+    const Game& game_;
+    const std::chrono::milliseconds budget_;
+    Solver solver_;
+
+    std::optional<Hint> hint_;
+    std::size_t generation_ = 0;
+    bool refining_ = false;
+
+    // Nothing if no cell has a finite probability to go on
+    std::optional<Hint> pick(const std::vector<double>& probs) const;
+};
+}
+
+#endif
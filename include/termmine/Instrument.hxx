@@ -0,0 +1,157 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_INSTRUMENT_HXX
+#define TERMMINE_INSTRUMENT_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/*
+* Counters and trace spans for the hot paths. They only exist when built with
+* TERMMINE_INSTRUMENT (the CMake option of the same name); otherwise the
+* macros below expand to nothing and cost nothing.
+*
+* Each thread counts into its own block, so counting is an inlined add and
+* threads never contend. Spans are only recorded after start_trace().
+*/
+#ifdef TERMMINE_INSTRUMENT
+
+namespace termmine::instrument {
+enum class Counter {
+    actions,         // open_cell() and chord_cell() calls from outside Game
+    cells_opened,
+    flood_fills,     // openings of a cell with no mines around it
+    flood_cells,     // cells opened by flood fills, including the first
+    neighbour_lists, // adjacent_cells() calls, each allocating a vector
+    frames,
+    frame_ns,
+    cells_redrawn,
+    count
+};
+
+// Largest values seen rather than totals
+enum class Peak {
+    flood_size,
+    pending, // cells queued by a flood fill at once
+    count
+};
+
+namespace detail {
+struct Totals {
+    std::array<std::uint64_t, static_cast<std::size_t>(Counter::count)>
+        counts;
+    std::array<std::uint64_t, static_cast<std::size_t>(Peak::count)> peaks;
+};
+
+// Only the owning thread writes its block, and others read it through
+// atomic_ref, which makes relaxed stores as cheap as plain ones
+extern constinit thread_local Totals totals;
+extern constinit thread_local bool registered;
+extern std::atomic<bool> trace_on;
+
+// Makes the calling thread's block visible to stats_line()
+void register_thread();
+}
+
+inline void add(const Counter counter, const std::uint64_t n) noexcept
+{
+    if (!detail::registered) [[unlikely]]
+        detail::register_thread();
+    auto& count = detail::totals.counts[static_cast<std::size_t>(counter)];
+    std::atomic_ref{count}.store(count + n, std::memory_order_relaxed);
+}
+
+inline void peak(const Peak peak, const std::uint64_t value) noexcept
+{
+    if (!detail::registered) [[unlikely]]
+        detail::register_thread();
+    auto& max = detail::totals.peaks[static_cast<std::size_t>(peak)];
+    if (value > max)
+        std::atomic_ref{max}.store(value, std::memory_order_relaxed);
+}
+
+void start_trace();
+inline bool tracing() noexcept
+{
+    return detail::trace_on.load(std::memory_order_relaxed);
+}
+// Records a finished span, with an optional named number attached
+void trace(const char* name, std::chrono::steady_clock::time_point start,
+           std::chrono::steady_clock::time_point end,
+           const char* arg_name = nullptr, std::uint64_t arg = 0);
+
+// Records the span of its own lifetime when tracing
+class Span final {
+public:
+    explicit Span(const char* name) noexcept;
+    ~Span();
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    void set_arg(const char* name, std::uint64_t value) noexcept;
+
+private:
+    const char* const name_;
+    const bool active_;
+    std::chrono::steady_clock::time_point start_;
+    const char* arg_name_ = nullptr;
+    std::uint64_t arg_ = 0;
+};
+
+// Totals over all threads, past and present, on one line. Where the system
+// reports it, this includes the bytes the whole process has written: the
+// terminal output along with autosaves, scores and replays.
+std::string stats_line();
+// Writes the recorded spans in Chrome's trace event format
+void write_trace(std::FILE* out);
+}
+
+#define TERMMINE_COUNT(counter, n) \
+    ::termmine::instrument::add(::termmine::instrument::Counter::counter, (n))
+#define TERMMINE_PEAK(which, value) \
+    ::termmine::instrument::peak(::termmine::instrument::Peak::which, (value))
+#define TERMMINE_SPAN(var, name) ::termmine::instrument::Span var{name}
+#define TERMMINE_SPAN_ARG(var, name, value) var.set_arg(name, (value))
+#define TERMMINE_TRACE(name, start, end) \
+    ::termmine::instrument::trace(name, start, end)
+
+#else
+
+#define TERMMINE_COUNT(counter, n) ((void)0)
+#define TERMMINE_PEAK(which, value) ((void)0)
+#define TERMMINE_SPAN(var, name) ((void)0)
+#define TERMMINE_SPAN_ARG(var, name, value) ((void)0)
+#define TERMMINE_TRACE(name, start, end) ((void)0)
+
+#endif
+
+#endif
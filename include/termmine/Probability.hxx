@@ -0,0 +1,94 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_PROBABILITY_HXX
+#define TERMMINE_PROBABILITY_HXX
+
+#include <atomic>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Game.hxx"
+#include "ThreadPool.hxx"
+
+namespace termmine {
+/*
+* Computes the exact chance of each cell being a mine from what the player can
+* see, assuming every layout consistent with it is equally likely.
+*
+* Unknown cells next to opened numbers are split into components that share
+* no constraints. Each component is enumerated on its own, in parallel, and
+* the components are combined using the number of mines left for the cells
+* no number touches.
+*/
+class ProbabilityEngine final {
+public:
+    // If use_flags is set, flagged cells are trusted to be mines
+    explicit ProbabilityEngine(ThreadPool& pool, bool use_flags = true);
+
+    // Probability of each cell (row * cols + col) being a mine, with opened
+    // cells at 0. Empty if no layout is consistent with the board.
+    std::vector<double> compute(const Game& game);
+    // Same, but gives up between steps once stop is set, returning nothing
+    // useful. Lets a stale computation be dropped early.
+    std::vector<double> compute(const Game& game,
+                                const std::atomic<bool>& stop);
+
+private:
+    // Unknown cells linked by the numbers around them
+    struct Component {
+        std::vector<int> cells;
+        std::vector<std::vector<int>> rules; // indices into cells
+        std::vector<int> rule_mines;
+
+        // ways[k] is the number of layouts with k mines, and
+        // mine_ways[k * cells.size() + i] how many of those have cell i mined
+        std::vector<double> ways;
+        std::vector<double> mine_ways;
+
+        void enumerate(int max_mines, const std::atomic<bool>& stop);
+    };
+
+    ThreadPool& pool_;
+    const bool use_flags_;
+    std::vector<double> log_factorial_;
+
+    double log_choose(int n, int k);
+};
+
+/*
+* Quick local approximation of the mine probabilities, for when the exact ones
+* would take too long. Each unknown cell gets the highest density of missing
+* mines among the numbers around it, or the board's overall density if none.
+*/
+std::vector<double> estimate_probabilities(const Game& game,
+                                           bool use_flags = true);
+
+// The unopened, unflagged cell least likely to be a mine, if any
+std::optional<std::pair<int, int>> safest_cell(const Game& game,
+                                               const std::vector<double>& probs);
+}
+
+#endif
@@ -0,0 +1,92 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_PROBABILITYWORKER_HXX
+#define TERMMINE_PROBABILITYWORKER_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Game.hxx"
+#include "Probability.hxx"
+#include "ThreadPool.hxx"
+#include "TripleBuffer.hxx"
+
+namespace termmine {
+/*
+* Computes mine probabilities for the heatmap and hints on a background
+* thread, from a copy of the game taken when the request is made. The game
+* loop only ever copies the game and checks for a result, so it never waits on
+* the engine.
+*/
+class ProbabilityWorker final {
+public:
+    struct Result {
+        // Game::changes() size of the snapshot the result was computed from
+        std::size_t generation = SIZE_MAX;
+        // Empty if no layout is consistent with the board
+        std::vector<double> probs;
+    };
+
+    ProbabilityWorker();
+    ~ProbabilityWorker();
+
+    // Replaces any request the worker hasn't finished yet
+    void request(const Game& game);
+    bool busy() const noexcept;
+
+    // Picks up the newest finished result, returning whether there was one
+    bool poll() noexcept;
+    const Result& result() const noexcept;
+    // Whether the current result still matches the game
+    bool fresh(const Game& game) const noexcept;
+
+private:
+    ThreadPool pool_;
+    ProbabilityEngine engine_;
+    TripleBuffer<Result> results_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::unique_ptr<const Game> next_; // guarded by mutex_
+    bool stopping_ = false;            // guarded by mutex_
+    // Set under mutex_ when the computation running is no longer wanted
+    std::atomic<bool> stale_{false};
+
+    std::size_t requested_ = SIZE_MAX; // only used by the game loop
+    std::atomic<std::size_t> finished_{SIZE_MAX};
+
+    std::thread thread_;
+
+    void work();
+};
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_REPLAY_HXX
+#define TERMMINE_REPLAY_HXX
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Game.hxx"
+
+namespace termmine {
+enum class Action : unsigned char {
+    open,
+    chord,
+    flag,
+    mark
+};
+
+// Applies an action the way the game loop does
+void apply_action(Game& game, Action action, int row, int col);
+
+/*
+* Replay files start with the magic "TMRP", a version byte, and the board's
+* rows, cols, mines and seed as varints. Each move follows as a varint of the
+* zigzagged change in cell index shifted left by 3 and or'ed with the action,
+* then a varint of the milliseconds since the previous move. The last record
+* has the end tag as its action, then a varint of the final time's change
+* and a byte that is 1 if the game was won.
+*
+* Nearby moves make small deltas, so most moves take two or three bytes.
+*/
+struct ReplayHeader {
+    int rows;
+    int cols;
+    int mines;
+    std::uint_fast64_t seed;
+};
+
+struct ReplayEvent {
+    Action action;
+    int row;
+    int col;
+    // Milliseconds on the game's timer when the move was made
+    std::int64_t time;
+};
+
+struct ReplayEnd {
+    bool won;
+    std::int64_t time;
+};
+
+class BadReplay final : public std::runtime_error {
+public:
+    BadReplay(const char* what) : runtime_error{what} {}
+};
+
+// Appends a game's moves to a file through a large buffer, so recording a
+// move is only a copy into memory
+class ReplayWriter final {
+public:
+    // good() is false if the file can't be created
+    ReplayWriter(const std::string& path, const Game& game);
+    ReplayWriter(const std::string& path, const ReplayHeader& header);
+    ~ReplayWriter();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool good() const noexcept;
+    void record(Action action, int row, int col, std::int64_t time);
+    // Time of the last move recorded
+    std::int64_t last_time() const noexcept;
+    // Writes the end record, syncs and closes the file
+    void finish(bool won, std::int64_t time);
+
+private:
+    static constexpr std::size_t buffer_size = 1 << 16;
+
+    const int cols_;
+    std::FILE* file_;
+    std::vector<char> buffer_;
+    int last_cell_ = 0;
+    std::int64_t last_time_ = 0;
+
+    void put_varint(std::uint64_t value);
+};
+
+// Reads a replay from memory, which must outlive the reader. Throws BadReplay
+// on malformed data.
+class ReplayReader final {
+public:
+    ReplayReader(const unsigned char* data, std::size_t size);
+
+    const ReplayHeader& header() const noexcept;
+    // The next move, or nothing once the end record has been read
+    std::optional<ReplayEvent> next();
+    // Only set after next() has returned nothing
+    const std::optional<ReplayEnd>& end() const noexcept;
+
+private:
+    const unsigned char* pos_;
+    const unsigned char* const end_of_data_;
+    ReplayHeader header_;
+    int last_cell_ = 0;
+    std::int64_t last_time_ = 0;
+    std::optional<ReplayEnd> end_;
+
+    std::uint64_t get_varint();
+};
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_REPLAYPLAYER_HXX
+#define TERMMINE_REPLAYPLAYER_HXX
+
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <vector>
+
+#include "Game.hxx"
+#include "Replay.hxx"
+
+namespace termmine {
+/*
+* Re-creates a recorded game from its seed and steps through its moves.
+*
+* Copies of the game are kept every so many moves while the replay is loaded,
+* so seeking restores the nearest earlier copy and only replays the moves
+* after it, however long the game was.
+*/
+class ReplayPlayer final {
+public:
+    // Reads every move up front, so throws BadReplay for any bad data
+    explicit ReplayPlayer(ReplayReader reader);
+
+    const Game& game() const noexcept;
+    const ReplayHeader& header() const noexcept;
+    const std::optional<ReplayEnd>& end() const noexcept;
+
+    // Number of moves applied so far
+    std::size_t position() const noexcept;
+    std::size_t size() const noexcept;
+    // The move applied last, if any
+    const ReplayEvent* last() const noexcept;
+
+    // Time of the last move applied, or 0 before the first
+    std::int64_t time() const noexcept;
+    // Time of the next move, or of the end once every move is applied
+    std::int64_t next_time() const noexcept;
+    // Length of the whole game
+    std::int64_t duration() const noexcept;
+
+    // Applies the next move, returning false if there are none left
+    bool step();
+    void seek(std::size_t position);
+    // Seeks to just after the last move made at or before time
+    void seek_time(std::int64_t time);
+
+private:
+    ReplayHeader header_;
+    std::vector<ReplayEvent> events_;
+    std::optional<ReplayEnd> end_;
+
+    std::size_t interval_;
+    // keyframes_[i] is the game after i * interval_ moves
+    std::vector<Game> keyframes_;
+
+    std::optional<Game> game_;
+    std::size_t position_ = 0;
+};
+}
+
+#endif
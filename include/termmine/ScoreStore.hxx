@@ -0,0 +1,100 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_SCORESTORE_HXX
+#define TERMMINE_SCORESTORE_HXX
+
+#include <cstdint>
+#include <cstdio>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace termmine {
+struct GameRecord {
+    int rows;
+    int cols;
+    int mines;
+    bool no_guess;
+    std::uint_fast64_t seed;
+    // Milliseconds from the first open to the last move
+    std::int64_t time;
+    int bbbv;
+    bool won;
+};
+
+// Totals for one kind of board
+struct BoardScores {
+    int games = 0;
+    int wins = 0;
+    // The fastest win, if any
+    std::optional<GameRecord> best;
+};
+
+/*
+* Keeps every finished game in an append-only log of fixed-size, checksummed
+* records, so a crash can at worst lose the game being written. A sidecar
+* index holds the totals per kind of board along with how many records it
+* covers, so loading reads only the index and any records appended after it.
+*
+* Files that can't be read or written leave the store empty rather than
+* failing, since scores are never worth stopping a game for.
+*/
+class ScoreStore final {
+public:
+    // Keeps the log and index in dir, creating it if needed. An empty dir
+    // disables the store.
+    explicit ScoreStore(const std::string& dir);
+    ~ScoreStore();
+
+    ScoreStore(const ScoreStore&) = delete;
+    ScoreStore& operator=(const ScoreStore&) = delete;
+
+    bool good() const noexcept;
+    // Appends a finished game, returning whether it set a new best time
+    bool add(const GameRecord& game);
+    // Totals for a kind of board, or nullptr if none have been played
+    const BoardScores* scores(int rows, int cols, int mines, bool no_guess)
+        const noexcept;
+
+private:
+    using Key = std::tuple<int, int, int, bool>;
+
+    std::string index_path_;
+    std::FILE* log_ = nullptr;
+    // Log records counted in scores_
+    std::uint64_t records_ = 0;
+    std::map<Key, BoardScores> scores_;
+
+    void apply(const GameRecord& game);
+    // Counts the records other processes or a crash left past records_
+    bool catch_up();
+    bool load_index();
+    void save_index() const;
+};
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_SOLVER_HXX
+#define TERMMINE_SOLVER_HXX
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Game.hxx"
+
+namespace termmine {
+/*
+* Finds cells that are certainly safe or certainly mines using only what the
+* player can see: the numbers of opened cells and, optionally, flags.
+*
+* Each opened cell with unknown neighbours is a constraint on how many of
+* them are mines. A constraint is re-examined only when one of its cells
+* becomes known, so catching up after a move costs time proportional to the
+* part of the frontier the move changed rather than the board size.
+*/
+class Solver final {
+public:
+    // If use_flags is set, flagged cells are trusted to be mines
+    explicit Solver(const Game& game, bool use_flags = true);
+
+    // Catches up with the cells opened or flagged since the last update
+    void update();
+
+    bool is_safe(int row, int col) const noexcept;
+    bool is_mine(int row, int col) const noexcept;
+
+    // A proven safe cell that hasn't been opened yet, if there is one. The
+    // same cell keeps being returned until it is opened.
+    std::optional<std::pair<int, int>> next_safe();
+
+    int safe_found() const noexcept;
+    int mines_found() const noexcept;
+
+private:
+    enum class Knowledge : unsigned char {
+        unknown,
+        safe,
+        mine,
+        flagged // trusted to be a mine only because of a flag
+    };
+
+    // The mines among the unknown neighbours of an opened cell
+    struct Constraint {
+        std::array<int, 8> cells;
+        int size = 0;
+        int mines = 0;
+        bool active = false;
+        bool queued = false;
+
+        bool contains(int cell) const noexcept;
+        // Whether every cell of this constraint is also in other
+        bool subset_of(const Constraint& other) const noexcept;
+    };
+
+    const Game& game_;
+    const bool use_flags_;
+    const int rows_;
+    const int cols_;
+
+    std::size_t seen_changes_ = 0;
+    std::vector<Knowledge> known_;
+    std::vector<Constraint> constraints_; // indexed by the opened cell
+    std::vector<int> queue_;
+    std::vector<int> safe_;
+
+    int safe_found_ = 0;
+    int mines_found_ = 0;
+
+    template <typename Func>
+    void for_each_adjacent(int cell, int radius, Func&& func) const;
+
+    void rebuild();
+    void open(int cell);
+    void set_safe(int cell);
+    void set_mine(int cell, Knowledge how);
+    // Removes a newly known cell from the constraints around it
+    void resolve(int cell, bool mine);
+    void enqueue(int cell);
+    void propagate();
+};
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_THREADPOOL_HXX
+#define TERMMINE_THREADPOOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace termmine {
+/*
+* Work-stealing thread pool. Each worker has its own queue and takes its
+* newest task first, and idle workers steal the oldest tasks from the others.
+*/
+class ThreadPool final {
+public:
+    // Uses one worker per hardware thread if threads is 0
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const noexcept;
+
+    void submit(std::function<void()> task);
+
+    // Calls func(i) for i from 0 to count - 1 and waits for all calls to
+    // finish. The calling thread runs tasks too, so this may be nested.
+    template <typename Func>
+    void parallel_for(std::size_t count, Func&& func);
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::size_t pending_ = 0; // guarded by sleep_mutex_
+    bool stopping_ = false;   // guarded by sleep_mutex_
+    std::atomic<unsigned> next_queue_{0};
+
+    void work(unsigned id);
+    // Runs one task, preferring queue id, and returns whether there was one
+    bool run_one(unsigned id);
+};
+
+template <typename Func>
+void ThreadPool::parallel_for(const std::size_t count, Func&& func)
+{
+    std::atomic<std::size_t> remaining{count};
+    for (std::size_t i = 0; i < count; ++i) {
+        submit([&func, &remaining, i] {
+            func(i);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    const unsigned id = next_queue_++ % size();
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!run_one(id))
+            std::this_thread::yield();
+    }
+}
+}
+
+#endif
@@ -30,8 +30,10 @@
 namespace termmine {
 class Timer final {
 public:
-    void start() noexcept;
+    // Starts as if the timer had already run for elapsed
+    void start(std::chrono::milliseconds elapsed = {}) noexcept;
     std::chrono::milliseconds::rep elapsed() const noexcept;
+    bool started() const noexcept;
 
 private:
     using clock_type = std::chrono::steady_clock;
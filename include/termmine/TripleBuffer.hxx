@@ -0,0 +1,88 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_TRIPLEBUFFER_HXX
+#define TERMMINE_TRIPLEBUFFER_HXX
+
+#include <array>
+#include <atomic>
+
+namespace termmine {
+/*
+* Lock-free slot passing the latest value from one writer thread to one
+* reader thread. The writer fills the back buffer and publishes it; the reader
+* picks up the newest published buffer, skipping any it never saw. Neither
+* side ever waits for the other.
+*/
+template <typename T>
+class TripleBuffer final {
+public:
+    // Writer only
+    T& back() noexcept;
+    void publish() noexcept;
+
+    // Reader only; returns whether a newer value was picked up
+    bool update() noexcept;
+    const T& front() const noexcept;
+
+private:
+    static constexpr unsigned fresh = 4; // middle buffer not yet picked up
+    static constexpr unsigned index = 3;
+
+    std::array<T, 3> buffers_{};
+    unsigned back_ = 0;
+    unsigned front_ = 1;
+    std::atomic<unsigned> middle_{2};
+};
+
+template <typename T>
+T& TripleBuffer<T>::back() noexcept
+{
+    return buffers_[back_];
+}
+
+template <typename T>
+void TripleBuffer<T>::publish() noexcept
+{
+    back_ = middle_.exchange(back_ | fresh, std::memory_order_acq_rel)
+        & index;
+}
+
+template <typename T>
+bool TripleBuffer<T>::update() noexcept
+{
+    if (!(middle_.load(std::memory_order_relaxed) & fresh))
+        return false;
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index;
+    return true;
+}
+
+template <typename T>
+const T& TripleBuffer<T>::front() const noexcept
+{
+    return buffers_[front_];
+}
+}
+
+#endif
@@ -0,0 +1,113 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "DebugOverlay.hxx"
+
+#include <cinttypes>
+
+#include <vector>
+
+#include <ncurses.h>
+
+#include "FrameScheduler.hxx"
+#include "Game.hxx"
+
+namespace termmine {
+DebugOverlay::DebugOverlay(const Game& game, const int y, const int x,
+                           const bool visible) noexcept
+    : y_{y},
+      x_{x},
+      rows_{game.rows()},
+      visible_{visible},
+      shown_(game.rows() * game.cols(), 0) {}
+
+bool DebugOverlay::visible() const noexcept
+{
+    return visible_;
+}
+
+void DebugOverlay::toggle() noexcept
+{
+    visible_ = !visible_;
+    if (visible_)
+        stale_ = true;
+    else
+        clear();
+}
+
+void DebugOverlay::invalidate() noexcept
+{
+    stale_ = true;
+}
+
+void DebugOverlay::count_key() noexcept
+{
+    ++keys_;
+}
+
+void DebugOverlay::update(const Game& game, const FrameScheduler& frames)
+    noexcept
+{
+    if (!visible_)
+        return;
+
+    if (stale_) {
+        mvprintw(y_, x_, "Seed: %" PRIuFAST64 "  Rate: ", game.seed());
+        if (frames.rate() > 0)
+            printw("%d Hz", frames.rate());
+        else
+            printw("on change");
+    }
+    mvprintw(y_ + 1, x_,
+             "Frame p50: %lldus p99: %lldus Frames: %zu Keys: %ld Redrawn: %ld",
+             static_cast<long long>(frames.percentile(50)),
+             static_cast<long long>(frames.percentile(99)), frames.frames(),
+             keys_, redrawn_);
+    clrtoeol();
+
+    // Only rewrite the bytes that changed since they were last shown
+    redrawn_ = 0;
+    for (int i = 0; const auto& row : game.board()) {
+        for (int j = 0; const auto cell : row) {
+            auto& shown = shown_[i * row.size() + j];
+            if (stale_ || shown != cell) {
+                mvprintw(y_ + 2 + i, x_ + j * 3, "%02x", cell);
+                shown = cell;
+                ++redrawn_;
+            }
+            ++j;
+        }
+        ++i;
+    }
+    stale_ = false;
+}
+
+void DebugOverlay::clear() const noexcept
+{
+    for (int i = 0; i < rows_ + 2; ++i) {
+        move(y_ + i, x_);
+        clrtoeol();
+    }
+}
+}
@@ -0,0 +1,72 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_DEBUGOVERLAY_HXX
+#define TERMMINE_DEBUGOVERLAY_HXX
+
+#include <vector>
+
+#include "FrameScheduler.hxx"
+#include "Game.hxx"
+
+namespace termmine {
+/*
+* Side panel showing the raw cell bytes, seed, frame timings and counters.
+*
+* Nothing is drawn while the overlay is hidden. While it is shown,
+* only the cell bytes that changed since the previous frame are rewritten.
+*/
+class DebugOverlay final {
+public:
+    DebugOverlay(const Game& game, int y, int x, bool visible) noexcept;
+
+    bool visible() const noexcept;
+    void toggle() noexcept;
+    // Redraw the whole panel on the next update
+    void invalidate() noexcept;
+
+    void count_key() noexcept;
+
+    // Draws to stdscr; the caller is responsible for refreshing it
+    void update(const Game& game, const FrameScheduler& frames) noexcept;
+
+private:
+    const int y_;
+    const int x_;
+    const int rows_;
+
+    bool visible_;
+    bool stale_ = true; // the whole panel needs to be redrawn
+
+    // Last drawn value of each cell, in row-major order
+    std::vector<unsigned char> shown_;
+
+    long keys_ = 0;
+    long redrawn_ = 0; // cell bytes rewritten by the last update
+
+    void clear() const noexcept;
+};
+}
+
+#endif
@@ -0,0 +1,122 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "FrameScheduler.hxx"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include "Instrument.hxx"
+
+namespace termmine {
+FrameScheduler::FrameScheduler(const int rate) noexcept
+    : rate_{rate},
+      period_{std::chrono::duration_cast<clock_type::duration>(
+          std::chrono::seconds{1}) / (rate > 0 ? rate : 1)},
+      next_frame_{clock_type::now()} {}
+
+int FrameScheduler::rate() const noexcept
+{
+    return rate_;
+}
+
+void FrameScheduler::invalidate() noexcept
+{
+    dirty_ = true;
+}
+
+bool FrameScheduler::dirty() const noexcept
+{
+    return dirty_;
+}
+
+void FrameScheduler::set_animating(const bool animating) noexcept
+{
+    animating_ = animating;
+}
+
+bool FrameScheduler::frame_due() const noexcept
+{
+    if (rate_ == 0 && dirty_)
+        return true;
+    if (!animating_ && !dirty_)
+        return false;
+    return clock_type::now() >= next_frame_;
+}
+
+int FrameScheduler::wait_ms() const noexcept
+{
+    if (rate_ == 0 && dirty_)
+        return 0;
+    if (!animating_ && !dirty_)
+        return -1;
+
+    const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+        next_frame_ - clock_type::now()).count();
+    return std::max<int>(wait, 0);
+}
+
+void FrameScheduler::frame_begin() noexcept
+{
+    frame_start_ = clock_type::now();
+}
+
+void FrameScheduler::frame_end() noexcept
+{
+    const auto now = clock_type::now();
+    history_[frames_ % history_size]
+        = std::chrono::duration_cast<std::chrono::microseconds>(
+            now - frame_start_).count();
+    ++frames_;
+    TERMMINE_COUNT(frames, 1);
+    TERMMINE_COUNT(frame_ns, std::chrono::duration_cast<
+        std::chrono::nanoseconds>(now - frame_start_).count());
+    TERMMINE_TRACE("frame", frame_start_, now);
+
+    dirty_ = false;
+    // Schedule from the start of this frame so slow frames don't drift
+    next_frame_ = std::max(frame_start_ + period_, now);
+}
+
+std::size_t FrameScheduler::frames() const noexcept
+{
+    return frames_;
+}
+
+std::chrono::microseconds::rep FrameScheduler::percentile(const double p)
+    const noexcept
+{
+    const std::size_t count = std::min(frames_, history_size);
+    if (count == 0)
+        return 0;
+
+    auto sorted = history_;
+    const auto nth = sorted.begin()
+        + std::min<std::size_t>(p / 100 * count, count - 1);
+    std::nth_element(sorted.begin(), nth, sorted.begin() + count);
+    return *nth;
+}
+}
@@ -0,0 +1,83 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_FRAMESCHEDULER_HXX
+#define TERMMINE_FRAMESCHEDULER_HXX
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace termmine {
+/*
+* Decides when the game loop should draw a frame.
+*
+* Input is handled as soon as it arrives, but drawing is capped at the target
+* rate. With a rate of 0, frames are only drawn when the game state changes,
+* plus once a second to keep the clock moving. While nothing is animating,
+* such as a clock that hasn't started, frames are only drawn for changes.
+*/
+class FrameScheduler final {
+public:
+    explicit FrameScheduler(int rate) noexcept;
+
+    int rate() const noexcept;
+
+    // Mark the board as changed so that the next frame redraws it
+    void invalidate() noexcept;
+    bool dirty() const noexcept;
+    // Whether anything on screen moves on its own, like a running clock
+    void set_animating(bool animating) noexcept;
+
+    bool frame_due() const noexcept;
+    // Milliseconds the loop may block waiting for input, -1 for indefinitely
+    // when nothing is animating and there is nothing to redraw
+    int wait_ms() const noexcept;
+
+    void frame_begin() noexcept;
+    void frame_end() noexcept;
+
+    std::size_t frames() const noexcept;
+    // Percentile (0 to 100) of the most recent frame times, in microseconds
+    std::chrono::microseconds::rep percentile(double p) const noexcept;
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    static constexpr std::size_t history_size = 512;
+
+    const int rate_;
+    const clock_type::duration period_;
+
+    bool dirty_ = true;
+    bool animating_ = true;
+    std::chrono::time_point<clock_type> next_frame_;
+    std::chrono::time_point<clock_type> frame_start_;
+
+    std::size_t frames_ = 0;
+    std::array<std::chrono::microseconds::rep, history_size> history_{};
+};
+}
+
+#endif
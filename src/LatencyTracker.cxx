@@ -0,0 +1,70 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "LatencyTracker.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace termmine {
+void LatencyTracker::key_pressed()
+{
+    pending_.push_back(clock_type::now());
+}
+
+void LatencyTracker::frame_shown()
+{
+    const auto now = clock_type::now();
+    for (const auto pressed : pending_) {
+        latencies_.push_back(std::chrono::duration_cast<
+            std::chrono::microseconds>(now - pressed).count());
+    }
+    pending_.clear();
+}
+
+void LatencyTracker::discard() noexcept
+{
+    pending_.clear();
+}
+
+std::size_t LatencyTracker::samples() const noexcept
+{
+    return latencies_.size();
+}
+
+std::chrono::microseconds::rep LatencyTracker::percentile(const double p)
+    const
+{
+    if (latencies_.empty())
+        return 0;
+
+    auto sorted = latencies_;
+    const auto nth = sorted.begin()
+        + std::min<std::size_t>(p / 100 * sorted.size(), sorted.size() - 1);
+    std::nth_element(sorted.begin(), nth, sorted.end());
+    return *nth;
+}
+}
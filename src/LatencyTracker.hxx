@@ -0,0 +1,58 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_LATENCYTRACKER_HXX
+#define TERMMINE_LATENCYTRACKER_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace termmine {
+/*
+* Measures how long each key takes to reach the screen: from when getch()
+* returns it to when the first frame drawn after it has been written out.
+* Keys handled before the same frame share that frame.
+*/
+class LatencyTracker final {
+public:
+    void key_pressed();
+    // Call once a frame has been sent to the terminal
+    void frame_shown();
+    // Forget keys whose effect will never be drawn
+    void discard() noexcept;
+
+    std::size_t samples() const noexcept;
+    // Percentile (0 to 100) of all latencies so far, in microseconds
+    std::chrono::microseconds::rep percentile(double p) const;
+
+private:
+    using clock_type = std::chrono::steady_clock;
+
+    std::vector<std::chrono::time_point<clock_type>> pending_;
+    std::vector<std::chrono::microseconds::rep> latencies_;
+};
+}
+
+#endif
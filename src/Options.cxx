@@ -0,0 +1,134 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Options.hxx"
+
+#include <cstdlib>
+
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace termmine {
+namespace {
+int parse_int(const std::string_view arg, const std::string_view value,
+              const int min, const int max)
+{
+    int num{};
+    const auto [end, ec] = std::from_chars(value.data(),
+                                           value.data() + value.size(), num);
+    if (ec != std::errc{} || end != value.data() + value.size() || num < min
+        || num > max) {
+        throw std::invalid_argument{"invalid value for " + std::string{arg}
+            + ": " + std::string{value}};
+    }
+    return num;
+}
+
+// Where per-user data goes on this platform, or empty if unknown
+std::string default_scores_dir()
+{
+#ifdef _WIN32
+    if (const char* const appdata = std::getenv("APPDATA"))
+        return std::string{appdata} + "\\termmine";
+#else
+    if (const char* const data = std::getenv("XDG_DATA_HOME"); data && *data)
+        return std::string{data} + "/termmine";
+    if (const char* const home = std::getenv("HOME"))
+        return std::string{home} + "/.local/share/termmine";
+#endif
+    return {};
+}
+}
+
+const char* const usage =
+    "Usage: termmine [options]\n"
+    "  --fps <rate>    Frame rate cap in Hz, 0 to draw only on change "
+    "(default 60)\n"
+    "  --unicode       Draw flags and mines with Unicode symbols\n"
+    "  --no-guess      Only deal boards that never need a guess\n"
+    "  --hint-budget <ms>\n"
+    "                  Longest a hint waits for exact odds (default 20)\n"
+    "  --record <dir>  Save a replay of every game to dir\n"
+    "  --replay <file> Play back a recorded game\n"
+    "  --scores <dir>  Keep results and best times in dir, empty for none\n"
+    "                  (default ~/.local/share/termmine)\n"
+    "  --latency       Report keypress to screen latency after each game\n"
+    "  --trace <file>  Write a Chrome trace of the session on exit\n"
+    "  --stats <file>  Append instrumentation counters every second\n";
+
+Options parse_options(const int argc, const char* const argv[])
+{
+    Options options;
+    options.scores_dir = default_scores_dir();
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--fps") {
+            if (++i == argc)
+                throw std::invalid_argument{"missing value for --fps"};
+            options.frame_rate = parse_int(arg, argv[i], 0, 1000);
+        } else if (arg == "--hint-budget") {
+            if (++i == argc)
+                throw std::invalid_argument{"missing value for --hint-budget"};
+            options.hint_budget = std::chrono::milliseconds{
+                parse_int(arg, argv[i], 0, 1000)};
+        } else if (arg == "--no-guess") {
+            options.no_guess = true;
+        } else if (arg == "--trace" || arg == "--stats") {
+#ifndef TERMMINE_INSTRUMENT
+            throw std::invalid_argument{std::string{arg}
+                + " needs a build with TERMMINE_INSTRUMENT"};
+#endif
+            if (++i == argc)
+                throw std::invalid_argument{"missing value for "
+                    + std::string{arg}};
+            (arg == "--trace" ? options.trace_file : options.stats_file)
+                = argv[i];
+        } else if (arg == "--record") {
+            if (++i == argc)
+                throw std::invalid_argument{"missing value for --record"};
+            options.record_dir = argv[i];
+        } else if (arg == "--replay") {
+            if (++i == argc)
+                throw std::invalid_argument{"missing value for --replay"};
+            options.replay_file = argv[i];
+        } else if (arg == "--scores") {
+            if (++i == argc)
+                throw std::invalid_argument{"missing value for --scores"};
+            options.scores_dir = argv[i];
+        } else if (arg == "--latency") {
+            options.latency = true;
+        } else if (arg == "--unicode") {
+            options.unicode = true;
+        } else {
+            throw std::invalid_argument{"unknown option: "
+                + std::string{arg}};
+        }
+    }
+    return options;
+}
+}
@@ -0,0 +1,61 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_OPTIONS_HXX
+#define TERMMINE_OPTIONS_HXX
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace termmine {
+struct Options {
+    // Target frame rate in Hz, 0 to only draw when the game state changes
+    int frame_rate = 60;
+    // Draw flags and mines with Unicode symbols
+    bool unicode = false;
+    // Only deal boards that can be cleared without guessing
+    bool no_guess = false;
+    // Longest a hint waits on exact probabilities before showing an estimate
+    std::chrono::milliseconds hint_budget{20};
+    // Report how long keys take to reach the screen at the end of a game
+    bool latency = false;
+    // Files to write the instrumentation's trace and stats lines to, if any
+    std::string trace_file;
+    std::string stats_file;
+    // Directory to save a replay of every game to, if any
+    std::string record_dir;
+    // Replay to play back instead of showing the menu, if any
+    std::string replay_file;
+    // Directory to keep every game's result and the best times in, if any
+    std::string scores_dir;
+};
+
+extern const char* const usage;
+
+// Throws std::invalid_argument on unknown or malformed arguments
+Options parse_options(int argc, const char* const argv[]);
+}
+
+#endif
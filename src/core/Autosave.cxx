@@ -0,0 +1,307 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Autosave.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "FileFormat.hxx"
+#include "Game.hxx"
+#include "Replay.hxx"
+
+namespace termmine {
+using namespace file_format;
+
+namespace {
+/*
+* The journal is the magic "TMJL", a version byte, the seed, the number of
+* moves before its first record and the game's id, then a 16 byte record per
+* move: the cell index, the time, the action, and a checksum of the rest.
+*/
+constexpr char magic[4]{'T', 'M', 'J', 'L'};
+constexpr unsigned char version = 2;
+constexpr std::size_t header_size = 32;
+constexpr std::size_t record_size = 16;
+
+// The checkpoint is a replay followed by "TMID" and the game's id
+constexpr char id_magic[4]{'T', 'M', 'I', 'D'};
+constexpr std::size_t id_size = 12;
+
+std::string checkpoint_path(const std::string& dir)
+{
+    return (std::filesystem::path{dir} / "autosave.tmr").string();
+}
+
+std::string journal_path(const std::string& dir)
+{
+    return (std::filesystem::path{dir} / "autosave.journal").string();
+}
+
+std::vector<unsigned char> read_file(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, {}};
+}
+
+// Random, so a game on the same seed as an earlier one still differs from it
+std::uint64_t new_game_id()
+{
+    std::random_device device;
+    return std::uint64_t{device()} << 32 | device();
+}
+}
+
+Game SavedGame::restore() const
+{
+    Game game{header.rows, header.cols, header.mines, header.seed};
+    for (const auto& move : moves)
+        apply_action(game, move.action, move.row, move.col);
+    game.resume_time(moves.empty() ? 0 : moves.back().time);
+    return game;
+}
+
+Autosave::Autosave(const std::string& dir, const Game& game,
+                   std::vector<ReplayEvent> history)
+    : dir_{dir},
+      header_{game.rows(), game.cols(), game.mines(), game.seed()},
+      id_{new_game_id()},
+      history_{std::move(history)}
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    worker_ = std::thread{[this] {
+        write_checkpoint();
+        work();
+    }};
+}
+
+Autosave::~Autosave()
+{
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+    if (journal_)
+        std::fclose(journal_);
+}
+
+void Autosave::record(const Action action, const int row, const int col,
+                      const std::int64_t time)
+{
+    {
+        std::lock_guard lock{mutex_};
+        if (discard_)
+            return;
+        pending_.push_back(ReplayEvent{action, row, col, time});
+    }
+    wake_.notify_one();
+}
+
+void Autosave::discard()
+{
+    {
+        std::lock_guard lock{mutex_};
+        discard_ = true;
+    }
+    wake_.notify_one();
+}
+
+std::optional<SavedGame> Autosave::load(const std::string& dir)
+{
+    const std::vector<unsigned char> checkpoint = read_file(
+        checkpoint_path(dir));
+    if (checkpoint.empty())
+        return std::nullopt;
+    std::size_t replay_size = checkpoint.size();
+    std::optional<std::uint64_t> id;
+    if (replay_size >= id_size
+        && !std::memcmp(checkpoint.data() + replay_size - id_size, id_magic,
+                        sizeof(id_magic))) {
+        replay_size -= id_size;
+        id = get64(checkpoint.data() + replay_size + sizeof(id_magic));
+    }
+    SavedGame saved;
+    try {
+        ReplayReader reader{checkpoint.data(), replay_size};
+        saved.header = reader.header();
+        while (const auto move = reader.next())
+            saved.moves.push_back(*move);
+    } catch (const BadReplay&) {
+        return std::nullopt;
+    }
+
+    // A journal for another game, even one on the same seed left behind by a
+    // crash before the journal was restarted, or one with a gap after the
+    // checkpoint, is left out
+    const std::vector<unsigned char> journal = read_file(journal_path(dir));
+    if (!id || journal.size() < header_size
+        || std::memcmp(journal.data(), magic, sizeof(magic))
+        || journal[sizeof(magic)] != version
+        || get64(journal.data() + 8) != saved.header.seed
+        || get64(journal.data() + 16) > saved.moves.size()
+        || get64(journal.data() + 24) != *id)
+        return saved;
+
+    // Moves the checkpoint already has are skipped
+    std::uint64_t index = get64(journal.data() + 16);
+    const int cells = saved.header.rows * saved.header.cols;
+    for (std::size_t pos = header_size; pos + record_size <= journal.size();
+         pos += record_size, ++index) {
+        const unsigned char* const record = journal.data() + pos;
+        if (get32(record + 12) != checksum(record, 12))
+            break;
+        if (index < saved.moves.size())
+            continue;
+        const std::uint32_t cell = get32(record);
+        if (cell >= static_cast<std::uint32_t>(cells)
+            || record[8] > static_cast<unsigned>(Action::mark))
+            break;
+        saved.moves.push_back(ReplayEvent{
+            static_cast<Action>(record[8]),
+            static_cast<int>(cell) / saved.header.cols,
+            static_cast<int>(cell) % saved.header.cols, get32(record + 4)});
+    }
+    return saved;
+}
+
+void Autosave::remove(const std::string& dir)
+{
+    std::error_code ec;
+    std::filesystem::remove(checkpoint_path(dir), ec);
+    std::filesystem::remove(journal_path(dir), ec);
+}
+
+void Autosave::work()
+{
+    std::unique_lock lock{mutex_};
+    while (true) {
+        wake_.wait(lock, [this] {
+            return !pending_.empty() || discard_ || stopping_;
+        });
+        if (discard_) {
+            lock.unlock();
+            if (journal_)
+                std::fclose(journal_);
+            journal_ = nullptr;
+            remove(dir_);
+            return;
+        }
+        if (pending_.empty())
+            return;
+
+        const std::vector<ReplayEvent> moves{std::move(pending_)};
+        pending_.clear();
+        lock.unlock();
+        append(moves);
+        lock.lock();
+    }
+}
+
+void Autosave::append(const std::vector<ReplayEvent>& moves)
+{
+    const std::size_t journaled = history_.size();
+    history_.insert(history_.end(), moves.begin(), moves.end());
+    if (history_.size() / checkpoint_every != journaled / checkpoint_every
+        && write_checkpoint())
+        return;
+    if (!journal_)
+        return;
+
+    std::vector<unsigned char> records(moves.size() * record_size);
+    unsigned char* record = records.data();
+    for (const auto& move : moves) {
+        std::memset(record, 0, record_size);
+        put32(record, move.row * header_.cols + move.col);
+        put32(record + 4, static_cast<std::uint32_t>(std::clamp<std::int64_t>(
+            move.time, 0, UINT32_MAX)));
+        record[8] = static_cast<unsigned char>(move.action);
+        put32(record + 12, checksum(record, 12));
+        record += record_size;
+    }
+    std::fwrite(records.data(), 1, records.size(), journal_);
+    sync(journal_);
+}
+
+bool Autosave::write_checkpoint()
+{
+    const std::string path = checkpoint_path(dir_);
+    const std::string temp_path = path + ".tmp";
+    {
+        ReplayWriter writer{temp_path, header_};
+        if (!writer.good())
+            return false;
+        for (const auto& move : history_)
+            writer.record(move.action, move.row, move.col, move.time);
+        writer.finish(false, history_.empty() ? 0 : history_.back().time);
+    }
+    std::FILE* const file = std::fopen(temp_path.c_str(), "ab");
+    if (!file)
+        return false;
+    unsigned char trailer[id_size];
+    std::memcpy(trailer, id_magic, sizeof(id_magic));
+    put64(trailer + sizeof(id_magic), id_);
+    const bool written = std::fwrite(trailer, 1, sizeof(trailer), file)
+        == sizeof(trailer);
+    sync(file);
+    if (std::fclose(file) || !written)
+        return false;
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec)
+        return false;
+
+    // The journal carries on from the checkpoint's last move
+    if (journal_)
+        std::fclose(journal_);
+    journal_ = std::fopen(journal_path(dir_).c_str(), "wb");
+    if (!journal_)
+        return true;
+    unsigned char header[header_size]{};
+    std::memcpy(header, magic, sizeof(magic));
+    header[sizeof(magic)] = version;
+    put64(header + 8, header_.seed);
+    put64(header + 16, history_.size());
+    put64(header + 24, id_);
+    std::fwrite(header, 1, sizeof(header), journal_);
+    sync(journal_);
+    return true;
+}
+}
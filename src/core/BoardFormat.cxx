@@ -0,0 +1,269 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "BoardFormat.hxx"
+
+#include <cstdint>
+#include <cstdio>
+
+#include <climits>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Game.hxx"
+
+namespace termmine {
+namespace {
+// Checks a board's size and mine count as soon as they are read, before
+// anything is allocated for them
+void check_size(const std::int64_t rows, const std::int64_t cols,
+                const std::int64_t mines)
+{
+    if (rows <= 0 || cols <= 0 || rows * cols > INT_MAX)
+        throw BadBoard{"Invalid board size"};
+    if (mines < 0 || mines >= rows * cols)
+        throw BadBoard{"Board has no safe cell"};
+}
+
+// Checks a board can be played, so Game never sees a bad one
+void check(const Board& board)
+{
+    check_size(board.rows, board.cols, board.mines.size());
+
+    std::vector<char> mined(board.rows * board.cols, false);
+    for (const int cell : board.mines) {
+        if (mined[cell])
+            throw BadBoard{"Two mines on one cell"};
+        mined[cell] = true;
+    }
+}
+
+bool is_space(const int c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+}
+
+std::optional<BoardFormat> board_format(const std::string_view name) noexcept
+{
+    if (name == "mbf")
+        return BoardFormat::mbf;
+    if (name == "grid")
+        return BoardFormat::grid;
+    if (name == "list")
+        return BoardFormat::list;
+    return std::nullopt;
+}
+
+BoardReader::BoardReader(std::FILE* const in, const BoardFormat format)
+    noexcept
+    : in_{in}, format_{format}
+{
+}
+
+std::optional<Board> BoardReader::next()
+{
+    std::optional<Board> board;
+    switch (format_) {
+    case BoardFormat::mbf:
+        board = next_mbf();
+        break;
+    case BoardFormat::grid:
+        board = next_grid();
+        break;
+    case BoardFormat::list:
+        board = next_list();
+        break;
+    }
+    if (board)
+        check(*board);
+    return board;
+}
+
+std::optional<Board> BoardReader::next_mbf()
+{
+    const int width = std::getc(in_);
+    if (width == EOF)
+        return std::nullopt;
+    const int height = std::getc(in_);
+    const int count_high = std::getc(in_);
+    const int count_low = std::getc(in_);
+    if (height == EOF || count_high == EOF || count_low == EOF)
+        throw BadBoard{"Truncated board"};
+
+    Board board{height, width, {}};
+    const int count = count_high << 8 | count_low;
+    check_size(height, width, count);
+    board.mines.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int x = std::getc(in_);
+        const int y = std::getc(in_);
+        if (x == EOF || y == EOF)
+            throw BadBoard{"Truncated board"};
+        if (x >= width || y >= height)
+            throw BadBoard{"Mine outside the board"};
+        board.mines.push_back(y * width + x);
+    }
+    return board;
+}
+
+std::optional<Board> BoardReader::next_grid()
+{
+    int c = std::getc(in_);
+    while (c == '\n' || c == '\r')
+        c = std::getc(in_);
+    if (c == EOF)
+        return std::nullopt;
+
+    // The width is only known at the end of the first row
+    Board board;
+    std::vector<std::pair<int, int>> mines;
+    int col = 0;
+    for (;; c = std::getc(in_)) {
+        if (c == '\r')
+            continue;
+        if (c == '\n' || c == EOF) {
+            // A blank line or the end of input ends the board
+            if (col == 0)
+                break;
+            if (board.rows == 0)
+                board.cols = col;
+            else if (col != board.cols)
+                throw BadBoard{"Rows of different lengths"};
+            ++board.rows;
+            col = 0;
+            if (c == EOF)
+                break;
+            continue;
+        }
+        if (c == '*')
+            mines.emplace_back(board.rows, col);
+        else if (c != '.')
+            throw BadBoard{"Unexpected character in grid"};
+        ++col;
+    }
+
+    board.mines.reserve(mines.size());
+    for (const auto& [row, mine_col] : mines)
+        board.mines.push_back(row * board.cols + mine_col);
+    return board;
+}
+
+std::optional<Board> BoardReader::next_list()
+{
+    const auto width = read_number();
+    if (!width)
+        return std::nullopt;
+    const auto height = read_number();
+    const auto count = read_number();
+    if (!height || !count)
+        throw BadBoard{"Truncated board"};
+
+    Board board{*height, *width, {}};
+    check_size(*height, *width, *count);
+    board.mines.reserve(*count);
+    for (int i = 0; i < *count; ++i) {
+        const auto x = read_number();
+        const auto y = read_number();
+        if (!x || !y)
+            throw BadBoard{"Truncated board"};
+        if (*x >= *width || *y >= *height)
+            throw BadBoard{"Mine outside the board"};
+        board.mines.push_back(*y * *width + *x);
+    }
+    return board;
+}
+
+std::optional<int> BoardReader::read_number()
+{
+    int c = std::getc(in_);
+    while (is_space(c))
+        c = std::getc(in_);
+    if (c == EOF)
+        return std::nullopt;
+
+    int num = 0;
+    for (; c != EOF && !is_space(c); c = std::getc(in_)) {
+        if (c < '0' || c > '9')
+            throw BadBoard{"Expected a number"};
+        if (num > (INT_MAX - 9) / 10)
+            throw BadBoard{"Number too large"};
+        num = num * 10 + (c - '0');
+    }
+    return num;
+}
+
+Board board_of(const Game& game)
+{
+    Board board{game.rows(), game.cols(), {}};
+    for (int i = 0; i < board.rows; ++i) {
+        for (int j = 0; j < board.cols; ++j) {
+            if (game.has_mine(i, j))
+                board.mines.push_back(i * board.cols + j);
+        }
+    }
+    return board;
+}
+
+void write_board(std::FILE* const out, const Board& board,
+                 const BoardFormat format)
+{
+    const int count = static_cast<int>(board.mines.size());
+    switch (format) {
+    case BoardFormat::mbf:
+        if (board.rows > 0xff || board.cols > 0xff || count > 0xffff)
+            throw BadBoard{"Board too large for mbf"};
+        std::putc(board.cols, out);
+        std::putc(board.rows, out);
+        std::putc(count >> 8, out);
+        std::putc(count & 0xff, out);
+        for (const int cell : board.mines) {
+            std::putc(cell % board.cols, out);
+            std::putc(cell / board.cols, out);
+        }
+        break;
+    case BoardFormat::grid: {
+        std::vector<bool> mine(std::size_t(board.rows) * board.cols);
+        for (const int cell : board.mines)
+            mine[cell] = true;
+        for (int i = 0; i < board.rows; ++i) {
+            for (int j = 0; j < board.cols; ++j)
+                std::putc(mine[i * board.cols + j] ? '*' : '.', out);
+            std::putc('\n', out);
+        }
+        std::putc('\n', out);
+        break;
+    }
+    case BoardFormat::list:
+        std::fprintf(out, "%d %d %d\n", board.cols, board.rows, count);
+        for (const int cell : board.mines)
+            std::fprintf(out, "%d %d\n", cell % board.cols, cell / board.cols);
+        break;
+    }
+    if (std::ferror(out))
+        throw BadBoard{"Cannot write the board"};
+}
+}
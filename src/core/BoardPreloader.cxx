@@ -0,0 +1,94 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "BoardPreloader.hxx"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <future>
+#include <optional>
+#include <random>
+
+#include "Game.hxx"
+#include "Generator.hxx"
+
+namespace termmine {
+BoardPreloader::BoardPreloader(const int rows, const int cols, const int mines,
+                               const std::optional<std::uint_fast64_t> seed,
+                               const bool no_guess)
+    : rows_{rows},
+      cols_{cols},
+      mines_{mines},
+      seed_{seed},
+      no_guess_{no_guess}
+{
+    if (no_guess_) {
+        // Give up on boards too dense to ever be solvable rather than hang
+        constexpr std::size_t max_tries = 10'000;
+        pool_.emplace();
+        generator_.emplace(*pool_, max_tries);
+    }
+    next_ = std::async(std::launch::async, [this] { return build(); });
+}
+
+BoardPreloader::~BoardPreloader()
+{
+    // Don't keep the player waiting on a board nobody will play
+    if (generator_)
+        generator_->cancel();
+    if (next_.valid())
+        next_.wait();
+}
+
+bool BoardPreloader::ready() const
+{
+    return next_.wait_for(std::chrono::seconds{0})
+        == std::future_status::ready;
+}
+
+BoardPreloader::Deal BoardPreloader::take()
+{
+    Deal deal{next_.get()};
+    next_ = std::async(std::launch::async, [this] { return build(); });
+    return deal;
+}
+
+BoardPreloader::Deal BoardPreloader::build()
+{
+    if (!no_guess_) {
+        return {seed_ ? Game{rows_, cols_, mines_, *seed_}
+                    : Game{rows_, cols_, mines_},
+                false};
+    }
+
+    std::random_device rd;
+    const std::uint_fast64_t base = seed_ ? *seed_
+        : static_cast<std::uint_fast64_t>(rd()) << 32 | rd();
+    // Without a solvable seed the base's own board is dealt, marked as such
+    const auto seed = generator_->find_seed(rows_, cols_, mines_, base);
+    return {Game{rows_, cols_, mines_, seed.value_or(base)}, seed.has_value()};
+}
+}
@@ -0,0 +1,150 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Corpus.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <vector>
+
+#include "FileFormat.hxx"
+
+namespace termmine {
+namespace {
+using namespace file_format;
+
+constexpr unsigned char magic[4] = {'T', 'M', 'B', 'C'};
+constexpr std::uint32_t version = 1;
+constexpr std::uint32_t no_guess_flag = 1;
+// Offset of the header's checksum, which covers everything before it
+constexpr std::size_t checksum_offset = 32;
+
+std::size_t words_for(const int rows, const int cols) noexcept
+{
+    return (std::size_t(rows) * cols + 63) / 64;
+}
+}
+
+std::size_t corpus_record_size(const int rows, const int cols) noexcept
+{
+    return 8 + 8 * words_for(rows, cols);
+}
+
+std::size_t corpus_file_size(const CorpusHeader& header) noexcept
+{
+    const std::size_t record_size = corpus_record_size(header.rows,
+                                                       header.cols);
+    if (header.boards > (SIZE_MAX - corpus_header_size) / record_size)
+        return SIZE_MAX;
+    return corpus_header_size + header.boards * record_size;
+}
+
+void write_corpus_header(unsigned char* const out,
+                         const CorpusHeader& header) noexcept
+{
+    std::memset(out, 0, corpus_header_size);
+    std::memcpy(out, magic, sizeof magic);
+    put16(out + 4, version);
+    put16(out + 6, header.no_guess ? no_guess_flag : 0);
+    put32(out + 8, header.rows);
+    put32(out + 12, header.cols);
+    put32(out + 16, header.mines);
+    put32(out + 20, static_cast<std::uint32_t>(
+        corpus_record_size(header.rows, header.cols)));
+    put64(out + 24, header.boards);
+    put32(out + checksum_offset, checksum(out, checksum_offset));
+}
+
+void write_corpus_board(unsigned char* const out, const CorpusHeader& header,
+                        const std::uint_fast64_t seed,
+                        const std::vector<int>& mine_cells) noexcept
+{
+    put64(out, seed);
+    unsigned char* const bits = out + 8;
+    std::memset(bits, 0, 8 * words_for(header.rows, header.cols));
+    for (const int cell : mine_cells)
+        bits[cell / 8] |= 1 << cell % 8;
+}
+
+CorpusView::CorpusView(const unsigned char* const data,
+                       const std::size_t size)
+    : records_{data + corpus_header_size}
+{
+    if (size < corpus_header_size
+        || std::memcmp(data, magic, sizeof magic) != 0)
+        throw BadCorpus{"Not a corpus file"};
+    if (get32(data + checksum_offset) != checksum(data, checksum_offset))
+        throw BadCorpus{"Corrupt corpus header"};
+    if (get16(data + 4) != version)
+        throw BadCorpus{"Unsupported corpus version"};
+
+    header_.rows = static_cast<int>(get32(data + 8));
+    header_.cols = static_cast<int>(get32(data + 12));
+    header_.mines = static_cast<int>(get32(data + 16));
+    header_.no_guess = get16(data + 6) & no_guess_flag;
+    header_.boards = get64(data + 24);
+    record_size_ = get32(data + 20);
+    if (header_.rows <= 0 || header_.cols <= 0
+        || record_size_ != corpus_record_size(header_.rows, header_.cols))
+        throw BadCorpus{"Malformed corpus header"};
+    if ((size - corpus_header_size) / record_size_ < header_.boards)
+        throw BadCorpus{"Corpus file is truncated"};
+}
+
+const CorpusHeader& CorpusView::header() const noexcept
+{
+    return header_;
+}
+
+std::uint64_t CorpusView::size() const noexcept
+{
+    return header_.boards;
+}
+
+std::uint_fast64_t CorpusView::seed(const std::uint64_t board) const noexcept
+{
+    return get64(record(board));
+}
+
+bool CorpusView::has_mine(const std::uint64_t board, const int row,
+                          const int col) const noexcept
+{
+    const int cell = row * header_.cols + col;
+    return mine_bits(board)[cell / 8] >> cell % 8 & 1;
+}
+
+const unsigned char*
+CorpusView::mine_bits(const std::uint64_t board) const noexcept
+{
+    return record(board) + 8;
+}
+
+const unsigned char*
+CorpusView::record(const std::uint64_t board) const noexcept
+{
+    return records_ + board * record_size_;
+}
+}
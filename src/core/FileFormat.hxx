@@ -0,0 +1,95 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_FILEFORMAT_HXX
+#define TERMMINE_FILEFORMAT_HXX
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Little-endian integers, checksums and syncing for the files the engine keeps
+namespace termmine::file_format {
+inline void put16(unsigned char* const out, const std::uint32_t value) noexcept
+{
+    out[0] = value & 0xff;
+    out[1] = value >> 8 & 0xff;
+}
+
+inline void put32(unsigned char* const out, const std::uint32_t value) noexcept
+{
+    put16(out, value & 0xffff);
+    put16(out + 2, value >> 16);
+}
+
+inline void put64(unsigned char* const out, const std::uint64_t value) noexcept
+{
+    put32(out, value & 0xffffffff);
+    put32(out + 4, value >> 32);
+}
+
+inline std::uint32_t get16(const unsigned char* const in) noexcept
+{
+    return in[0] | in[1] << 8;
+}
+
+inline std::uint32_t get32(const unsigned char* const in) noexcept
+{
+    return get16(in) | get16(in + 2) << 16;
+}
+
+inline std::uint64_t get64(const unsigned char* const in) noexcept
+{
+    return get32(in) | std::uint64_t{get32(in + 4)} << 32;
+}
+
+// FNV-1a, to catch records torn by a crash
+inline std::uint32_t checksum(const unsigned char* const data,
+                              const std::size_t size) noexcept
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+// Flushes a file through to the disk
+inline void sync(std::FILE* const file) noexcept
+{
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+}
+
+#endif
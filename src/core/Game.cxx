@@ -0,0 +1,537 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Game.hxx"
+
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Instrument.hxx"
+
+namespace termmine {
+Game::Game(const int rows, const int cols, const int mines) noexcept
+    : Game{rows, cols, mines, std::random_device{}} {}
+
+Game::Game(const int rows, const int cols, const int mines,
+           const std::uint_fast64_t seed) noexcept
+    : rows_{rows},
+      cols_{cols},
+      mines_{mines},
+      seed_{seed},
+      board_(rows, std::vector<unsigned char>(cols, 0))
+{
+    for (const int cell : mine_layout(rows, cols, mines, seed_))
+        toggle_mine(cell / cols, cell % cols);
+    finish_board();
+}
+
+Game::Game(const int rows, const int cols,
+           const std::vector<int>& mine_cells) noexcept
+    : rows_{rows},
+      cols_{cols},
+      mines_{static_cast<int>(mine_cells.size())},
+      seed_{0},
+      board_(rows, std::vector<unsigned char>(cols, 0))
+{
+    for (const int cell : mine_cells)
+        toggle_mine(cell / cols, cell % cols);
+    finish_board();
+}
+
+Game::Game(const int rows, const int cols, const int mines,
+           std::random_device&& rd) noexcept
+    : Game{rows, cols, mines,
+        static_cast<std::uint_fast64_t>(rd()) << 32 | rd()} {}
+
+std::vector<int> Game::mine_layout(const int rows, const int cols,
+                                   const int mines,
+                                   const std::uint_fast64_t seed)
+{
+    std::vector<int> cells;
+    mine_layout(rows, cols, mines, seed, cells);
+    return cells;
+}
+
+void Game::mine_layout(const int rows, const int cols, const int mines,
+                       const std::uint_fast64_t seed, std::vector<int>& cells)
+{
+    // Assign a number to each cell and randomize mine placement
+    cells.resize(rows * cols);
+    std::iota(cells.begin(), cells.end(), 0);
+
+    std::mt19937_64 gen{seed};
+    std::ranges::shuffle(cells, gen);
+    cells.resize(mines);
+}
+
+int Game::rows() const noexcept
+{
+    return rows_;
+}
+
+int Game::cols() const noexcept
+{
+    return cols_;
+}
+
+int Game::mines() const noexcept
+{
+    return mines_;
+}
+
+std::uint_fast64_t Game::seed() const noexcept
+{
+    return seed_;
+}
+
+const std::vector<std::vector<unsigned char>>& Game::board() const noexcept
+{
+    return board_;
+}
+
+std::chrono::milliseconds::rep Game::get_time() const noexcept
+{
+    return timer_.elapsed();
+}
+
+bool Game::timer_started() const noexcept
+{
+    return timer_.started();
+}
+
+void Game::resume_time(const std::chrono::milliseconds::rep time) noexcept
+{
+    if (open_cells_ > 0)
+        timer_.start(std::chrono::milliseconds{time});
+}
+
+const std::vector<int>& Game::changes() const noexcept
+{
+    return changes_;
+}
+
+bool Game::is_over() const noexcept
+{
+    return game_over_;
+}
+
+bool Game::has_won() const noexcept
+{
+    return won_;
+}
+
+int Game::flags() const noexcept
+{
+    return cells_flagged_;
+}
+
+int Game::bbbv() const noexcept
+{
+    return bbbv_;
+}
+
+int Game::solved_bbbv() const noexcept
+{
+    return solved_bbbv_;
+}
+
+int Game::clicks() const noexcept
+{
+    return clicks_;
+}
+
+void Game::check_win(const int row, const int col) noexcept
+{
+    if (open_cells_ + mines_ == rows_ * cols_ && !has_mine(row, col)) {
+        won_ = true;
+        game_over_ = true;
+
+        // Autoflag all unflagged cells
+        for (int i = 0; i < rows_; ++i) {
+            for (int j = 0; j < cols_; ++j) {
+                if (has_mine(i, j) && !has_flag(i, j))
+                    toggle_flag(i, j);
+            }
+        }
+    }
+}
+
+bool Game::has_mine(const int row, const int col) const noexcept
+{
+    return board_[row][col] & (1u << 7);
+}
+
+bool Game::is_open(const int row, const int col) const noexcept
+{
+    return board_[row][col] & (1u << 6);
+}
+
+bool Game::has_flag(const int row, const int col) const noexcept
+{
+    return board_[row][col] & (1u << 5);
+}
+
+bool Game::has_mark(const int row, const int col) const noexcept
+{
+    return board_[row][col] & (1u << 4);
+}
+
+int Game::num_adj_mines(const int row, const int col) const noexcept
+{
+    return board_[row][col] & 0b1111u;
+}
+
+void Game::open_cell(const int row, const int col)
+{
+    TERMMINE_SPAN(span, "open_cell");
+    ++clicks_;
+    [[maybe_unused]] const int opened = open_cells_;
+    open_region(row, col);
+    TERMMINE_COUNT(actions, 1);
+    TERMMINE_COUNT(cells_opened, open_cells_ - opened);
+    TERMMINE_SPAN_ARG(span, "cells", open_cells_ - opened);
+}
+
+void Game::chord_cell(const int row, const int col)
+{
+    ++clicks_;
+    if (!is_open(row, col))
+        return;
+
+    int flags = 0;
+    for (const auto& adj : adjacent_cells(row, col))
+        flags += has_flag(adj.first, adj.second);
+    if (flags != num_adj_mines(row, col))
+        return;
+
+    TERMMINE_SPAN(span, "chord_cell");
+    [[maybe_unused]] const int opened = open_cells_;
+    for (const auto& adj : adjacent_cells(row, col))
+        open_region(adj.first, adj.second);
+    TERMMINE_COUNT(actions, 1);
+    TERMMINE_COUNT(cells_opened, open_cells_ - opened);
+    TERMMINE_SPAN_ARG(span, "cells", open_cells_ - opened);
+}
+
+void Game::open_region(const int row, const int col)
+{
+    // Cells left to open, as row * cols + col. A worklist rather than
+    // recursion, since a flood held up by flags can reach across the board.
+    flood_.assign(1, row * cols_ + col);
+    [[maybe_unused]] const int opened = open_cells_;
+    bool flooded = false;
+    while (!flood_.empty()) {
+        TERMMINE_PEAK(pending, flood_.size());
+        const int cell = flood_.back();
+        flood_.pop_back();
+        const int y = cell / cols_;
+        const int x = cell % cols_;
+        if (is_open(y, x) || has_flag(y, x) || has_mark(y, x))
+            continue;
+
+        if (open_cells_ == 0)
+            timer_.start();
+
+        board_[y][x] |= 1u << 6; // set opened flag
+        ++open_cells_;
+        changes_.push_back(cell);
+        if (has_mine(y, x)) {
+            if (open_cells_ == 1) {
+                // Prevent a first-move loss
+                std::pair<int, int> open_cell{first_open_cell()};
+                toggle_mine(open_cell.first, open_cell.second);
+                toggle_mine(y, x);
+                finish_board();
+            } else {
+                game_over_ = true;
+                continue;
+            }
+        }
+
+        const int click = click_of_[cell];
+        const bool first = click >= 0 && !click_solved_[click];
+        if (first) {
+            click_solved_[click] = true;
+            ++solved_bbbv_;
+        }
+
+        if (num_adj_mines(y, x) != 0)
+            continue;
+        flooded = flooded || cell == row * cols_ + col;
+        if (first && region_blocked_[click] == 0) {
+            // Nothing in the region is open or in the way, so all of it and
+            // its border opens, as a flood would
+            for (int i = region_first_[click]; i < region_first_[click + 1];
+                 ++i) {
+                const int ry = region_cells_[i] / cols_;
+                const int rx = region_cells_[i] % cols_;
+                if (is_open(ry, rx) || has_flag(ry, rx) || has_mark(ry, rx))
+                    continue;
+                board_[ry][rx] |= 1u << 6;
+                ++open_cells_;
+                changes_.push_back(region_cells_[i]);
+            }
+        } else {
+            for (int i = std::max(y - 1, 0); i <= std::min(y + 1, rows_ - 1);
+                 ++i) {
+                for (int j = std::max(x - 1, 0);
+                     j <= std::min(x + 1, cols_ - 1); ++j) {
+                    if (!is_open(i, j))
+                        flood_.push_back(i * cols_ + j);
+                }
+            }
+        }
+    }
+
+    if (flooded) {
+        TERMMINE_COUNT(flood_fills, 1);
+        TERMMINE_COUNT(flood_cells, open_cells_ - opened);
+        TERMMINE_PEAK(flood_size, open_cells_ - opened);
+    }
+}
+
+void Game::flag_cell(const int row, const int col) noexcept
+{
+    ++clicks_;
+    toggle_flag(row, col);
+}
+
+void Game::toggle_flag(const int row, const int col) noexcept
+{
+    if (is_open(row, col))
+        return;
+
+    const bool was_blocked = has_flag(row, col) || has_mark(row, col);
+    board_[row][col] &= ~(1u << 4); // unmark cell first
+    board_[row][col] ^= 1u << 5;
+    update_blocked(row, col, was_blocked);
+
+    if ((board_[row][col] & (1u << 5)) == 1u << 5)
+        ++cells_flagged_;
+    else
+        --cells_flagged_;
+    changes_.push_back(row * cols_ + col);
+}
+
+void Game::mark_cell(const int row, const int col) noexcept
+{
+    ++clicks_;
+    const bool was_blocked = has_flag(row, col) || has_mark(row, col);
+    if (has_flag(row, col)) {
+        // Unflag cell first
+        board_[row][col] &= ~(1u << 5);
+        --cells_flagged_;
+        changes_.push_back(row * cols_ + col);
+    }
+    board_[row][col] ^= 1u << 4;
+    update_blocked(row, col, was_blocked);
+}
+
+void Game::update_blocked(const int row, const int col,
+                          const bool was_blocked) noexcept
+{
+    const int click = click_of_[row * cols_ + col];
+    if (click < 0 || click >= regions_)
+        return;
+    const bool blocked = has_flag(row, col) || has_mark(row, col);
+    region_blocked_[click] += blocked - was_blocked;
+}
+
+void Game::finish_board() noexcept
+{
+    // Each mine adds itself to its neighbours' counts, so a board takes one
+    // pass and no lists of adjacent cells
+    for (auto& row : board_) {
+        for (auto& cell : row)
+            cell &= ~0b1111u;
+    }
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < cols_; ++j) {
+            if (!has_mine(i, j))
+                continue;
+            for (int y = std::max(i - 1, 0); y <= std::min(i + 1, rows_ - 1);
+                 ++y) {
+                for (int x = std::max(j - 1, 0);
+                     x <= std::min(j + 1, cols_ - 1); ++x) {
+                    if (y != i || x != j)
+                        ++board_[y][x];
+                }
+            }
+        }
+    }
+    label_regions();
+}
+
+void Game::toggle_mine(const int row, const int col) noexcept
+{
+    board_[row][col] ^= 1u << 7;
+}
+
+std::vector<std::pair<int, int>> Game::adjacent_cells(
+    const int row, const int col) const noexcept
+{
+    std::vector<std::pair<int, int>> adj;
+    TERMMINE_COUNT(neighbour_lists, 1);
+
+    for (int i = row - 1; i <= row + 1; ++i) {
+        for (int j = col - 1; j <= col + 1; ++j) {
+            if (i >= 0 && i < rows_ && j >= 0 && j < cols_
+                && (i != row || j != col))
+            adj.push_back({i, j});
+        }
+    }
+    return adj;
+}
+
+std::pair<int, int> Game::first_open_cell() const
+{
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < rows_; ++j) {
+            if (!has_mine(i, j))
+                return {i, j};
+        }
+    }
+    throw BadGameState("No safe cells present in board");
+}
+
+
+void Game::label_regions()
+{
+    const int cells = rows_ * cols_;
+    // Looked up many times per cell, so worked out once up front
+    std::vector<char> zeros(cells);
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < cols_; ++j)
+            zeros[i * cols_ + j] = (board_[i][j] & 0b10001111u) == 0;
+    }
+    auto zero = [&zeros](const int cell) { return zeros[cell] != 0; };
+
+    // Union each zero with the zeros next to it that came before it, keeping
+    // the first cell of each region as its root
+    std::vector<int> parent(cells);
+    auto find = [&parent](int cell) {
+        while (parent[cell] != cell) {
+            parent[cell] = parent[parent[cell]];
+            cell = parent[cell];
+        }
+        return cell;
+    };
+    constexpr std::array<std::pair<int, int>, 4> before{{
+        {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}
+    }};
+    for (int cell = 0; cell < cells; ++cell) {
+        parent[cell] = cell;
+        if (!zero(cell))
+            continue;
+        for (const auto& [dy, dx] : before) {
+            const int y = cell / cols_ + dy;
+            const int x = cell % cols_ + dx;
+            if (y < 0 || x < 0 || x >= cols_ || !zero(y * cols_ + x))
+                continue;
+            const int a = find(cell);
+            const int b = find(y * cols_ + x);
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    // Roots come first, so one pass numbers the regions
+    constexpr int none = -1;
+    click_of_.assign(cells, none);
+    regions_ = 0;
+    for (int cell = 0; cell < cells; ++cell) {
+        if (zero(cell)) {
+            const int root = find(cell);
+            click_of_[cell] = root == cell ? regions_++ : click_of_[root];
+        }
+    }
+
+    // Calls func once for each region a number borders
+    auto border_of = [this, &zero](const int cell, auto&& func) {
+        std::array<int, 8> seen;
+        int count = 0;
+        const int row = cell / cols_;
+        const int col = cell % cols_;
+        for (int y = std::max(row - 1, 0); y <= std::min(row + 1, rows_ - 1);
+             ++y) {
+            for (int x = std::max(col - 1, 0);
+                 x <= std::min(col + 1, cols_ - 1); ++x) {
+                if (!zero(y * cols_ + x))
+                    continue;
+                const int region = click_of_[y * cols_ + x];
+                if (std::find(seen.begin(), seen.begin() + count, region)
+                    == seen.begin() + count) {
+                    seen[count++] = region;
+                    func(region);
+                }
+            }
+        }
+    };
+
+    // Size each region's list, then fill in its cells before its border
+    region_first_.assign(regions_ + 1, 0);
+    for (int cell = 0; cell < cells; ++cell) {
+        if (zero(cell))
+            ++region_first_[click_of_[cell] + 1];
+        else if (!has_mine(cell / cols_, cell % cols_))
+            border_of(cell, [this](const int region) {
+                ++region_first_[region + 1];
+            });
+    }
+    for (int region = 0; region < regions_; ++region)
+        region_first_[region + 1] += region_first_[region];
+    region_cells_.resize(region_first_[regions_]);
+    std::vector<int> next(region_first_.begin(), region_first_.end() - 1);
+    for (int cell = 0; cell < cells; ++cell) {
+        if (zero(cell))
+            region_cells_[next[click_of_[cell]]++] = cell;
+    }
+    bbbv_ = regions_;
+    for (int cell = 0; cell < cells; ++cell) {
+        if (zero(cell) || has_mine(cell / cols_, cell % cols_))
+            continue;
+        bool bordered = false;
+        border_of(cell, [&](const int region) {
+            region_cells_[next[region]++] = cell;
+            bordered = true;
+        });
+        if (!bordered)
+            click_of_[cell] = bbbv_++;
+    }
+    click_solved_.assign(bbbv_, false);
+
+    region_blocked_.assign(regions_, 0);
+    for (int cell = 0; cell < cells; ++cell) {
+        const int row = cell / cols_;
+        const int col = cell % cols_;
+        if (zero(cell) && (has_flag(row, col) || has_mark(row, col)))
+            ++region_blocked_[click_of_[cell]];
+    }
+}
+}
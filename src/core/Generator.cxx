@@ -0,0 +1,145 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Generator.hxx"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <utility>
+
+#include "Game.hxx"
+#include "Solver.hxx"
+#include "ThreadPool.hxx"
+
+namespace termmine {
+bool solvable_without_guessing(Game game, int row, int col)
+{
+    // A mine under the first click would be moved, changing the layout
+    if (game.has_mine(row, col))
+        return false;
+
+    Solver solver{game, false};
+    while (true) {
+        game.open_cell(row, col);
+        game.check_win(row, col);
+        if (game.is_over())
+            return game.has_won();
+
+        solver.update();
+        const auto cell = solver.next_safe();
+        if (!cell)
+            return false;
+        row = cell->first;
+        col = cell->second;
+    }
+}
+
+NoGuessGenerator::NoGuessGenerator(ThreadPool& pool,
+                                   const std::size_t max_tries) noexcept
+    : pool_{pool}, max_tries_{max_tries}
+{
+}
+
+std::optional<std::uint_fast64_t> NoGuessGenerator::find_seed(
+    const int rows, const int cols, const int mines,
+    const std::uint_fast64_t base)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto [row, col] = start_cell(rows, cols);
+    // Enough candidates per batch to keep every thread busy between the
+    // checks for a winner
+    const std::size_t batch = pool_.size() * 8;
+
+    std::optional<std::uint_fast64_t> seed;
+    for (std::size_t first = 0; first < max_tries_ && !seed; first += batch) {
+        if (cancelled_.load(std::memory_order_relaxed))
+            break;
+        const std::size_t count = std::min(batch, max_tries_ - first);
+        std::atomic<std::size_t> best{count};
+        std::atomic<std::uint64_t> tried{0};
+        std::atomic<std::uint64_t> solvable{0};
+
+        pool_.parallel_for(count, [&, row = row, col = col](std::size_t i) {
+            // Candidates after one already accepted can't win
+            if (i > best.load(std::memory_order_relaxed)
+                || cancelled_.load(std::memory_order_relaxed))
+                return;
+            tried.fetch_add(1, std::memory_order_relaxed);
+            const Game game{rows, cols, mines, derive_seed(base, first + i)};
+            if (!solvable_without_guessing(game, row, col))
+                return;
+            solvable.fetch_add(1, std::memory_order_relaxed);
+
+            std::size_t current = best.load(std::memory_order_relaxed);
+            while (i < current
+                   && !best.compare_exchange_weak(current, i,
+                                                  std::memory_order_relaxed))
+                ;
+        });
+
+        stats_.tried += tried.load(std::memory_order_relaxed);
+        stats_.solvable += solvable.load(std::memory_order_relaxed);
+        if (best < count && !cancelled_.load(std::memory_order_relaxed))
+            seed = derive_seed(base, first + best);
+    }
+
+    stats_.accepted += seed.has_value();
+    stats_.elapsed += std::chrono::steady_clock::now() - start;
+    return seed;
+}
+
+void NoGuessGenerator::cancel() noexcept
+{
+    cancelled_.store(true, std::memory_order_relaxed);
+}
+
+std::uint_fast64_t NoGuessGenerator::derive_seed(
+    const std::uint_fast64_t base, const std::size_t i) noexcept
+{
+    if (i == 0)
+        return base;
+
+    // SplitMix64, which spreads consecutive inputs over the whole range
+    std::uint64_t z = base + i * 0x9e3779b97f4a7c15u;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+
+std::pair<int, int> NoGuessGenerator::start_cell(const int rows,
+                                                 const int cols) noexcept
+{
+    return {rows / 2, cols / 2};
+}
+
+const NoGuessGenerator::Stats& NoGuessGenerator::stats() const noexcept
+{
+    return stats_;
+}
+}
@@ -0,0 +1,134 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "HintEngine.hxx"
+
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Game.hxx"
+#include "Probability.hxx"
+#include "ProbabilityWorker.hxx"
+
+namespace termmine {
+HintEngine::HintEngine(const Game& game,
+                       const std::chrono::milliseconds budget)
+    : game_{game}, budget_{budget}, solver_{game, false}
+{
+}
+
+std::optional<Hint> HintEngine::request(ProbabilityWorker& worker)
+{
+    using clock = std::chrono::steady_clock;
+    const auto deadline = clock::now() + budget_;
+
+    generation_ = game_.changes().size();
+    refining_ = false;
+
+    // Flags are the player's guesses, so neither step trusts them
+    solver_.update();
+    if (const auto safe = solver_.next_safe()) {
+        hint_ = Hint{safe->first, safe->second, true};
+        return hint_;
+    }
+
+    // The first cell opened is never a mine
+    bool opened = false;
+    for (int i = 0; i < game_.rows() && !opened; ++i) {
+        for (int j = 0; j < game_.cols() && !opened; ++j)
+            opened = game_.is_open(i, j);
+    }
+    if (!opened) {
+        hint_ = Hint{game_.rows() / 2, game_.cols() / 2, true};
+        return hint_;
+    }
+
+    // A request for this board stops any older computation, so the wait is
+    // only ever for a result matching generation_
+    worker.request(game_);
+    while (!worker.fresh(game_) && clock::now() < deadline) {
+        if (!worker.poll())
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    std::optional<Hint> exact;
+    if (worker.fresh(game_))
+        exact = pick(worker.result().probs);
+    else
+        refining_ = worker.busy();
+    // An inconsistent board, or one without a finite exact probability, gets
+    // the estimate
+    hint_ = exact ? exact : pick(estimate_probabilities(game_, false));
+    return hint_;
+}
+
+bool HintEngine::refine(ProbabilityWorker& worker)
+{
+    if (!refining_ || generation_ != game_.changes().size()) {
+        refining_ = false;
+        return false;
+    }
+
+    worker.poll();
+    if (!worker.fresh(game_))
+        return false;
+    refining_ = false;
+    // A board without a usable exact result keeps the estimate
+    const auto exact = pick(worker.result().probs);
+    if (!exact)
+        return false;
+    const bool changed = exact.has_value() != hint_.has_value()
+        || (exact && (exact->row != hint_->row || exact->col != hint_->col
+                      || exact->safe != hint_->safe));
+    hint_ = exact;
+    return changed;
+}
+
+bool HintEngine::refining() const noexcept
+{
+    return refining_;
+}
+
+std::optional<Hint> HintEngine::current() const noexcept
+{
+    if (generation_ != game_.changes().size())
+        return std::nullopt;
+    return hint_;
+}
+
+std::optional<Hint> HintEngine::pick(const std::vector<double>& probs) const
+{
+    if (probs.empty())
+        return std::nullopt;
+    const auto cell = safest_cell(game_, probs);
+    if (!cell)
+        return std::nullopt;
+    const double prob = probs[cell->first * game_.cols() + cell->second];
+    if (!std::isfinite(prob))
+        return std::nullopt;
+    return Hint{cell->first, cell->second, prob < 1e-9};
+}
+}
@@ -0,0 +1,251 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Instrument.hxx"
+
+#ifdef TERMMINE_INSTRUMENT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace termmine::instrument {
+namespace {
+constexpr std::size_t num_counters = static_cast<std::size_t>(Counter::count);
+constexpr std::size_t num_peaks = static_cast<std::size_t>(Peak::count);
+// Per thread, so a long trace can't use up all memory
+constexpr std::size_t max_events = 1 << 20;
+
+struct Event {
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    const char* arg_name;
+    std::uint64_t arg;
+    unsigned thread;
+};
+
+using detail::Totals;
+
+struct ThreadBlock;
+
+// Guards everything below. Taken before a block's events_mutex when both are.
+std::mutex registry_mutex;
+std::vector<ThreadBlock*> blocks;
+Totals retired{};
+std::vector<Event> retired_events;
+unsigned next_thread = 1;
+
+const auto epoch = std::chrono::steady_clock::now();
+
+// A thread's counters and trace, registered for as long as the thread lives
+struct ThreadBlock {
+    Totals& totals = detail::totals;
+    // Only contended while the trace is written or the thread retires, so
+    // recording stays cheap on every worker at once
+    std::mutex events_mutex;
+    std::vector<Event> events;
+    unsigned thread;
+
+    ThreadBlock()
+    {
+        std::lock_guard lock{registry_mutex};
+        thread = next_thread++;
+        blocks.push_back(this);
+    }
+
+    ~ThreadBlock()
+    {
+        std::lock_guard lock{registry_mutex};
+        for (std::size_t i = 0; i < num_counters; ++i)
+            retired.counts[i] += totals.counts[i];
+        for (std::size_t i = 0; i < num_peaks; ++i)
+            retired.peaks[i] = std::max(retired.peaks[i], totals.peaks[i]);
+        std::lock_guard events_lock{events_mutex};
+        retired_events.insert(retired_events.end(), events.begin(),
+                              events.end());
+        std::erase(blocks, this);
+    }
+};
+
+ThreadBlock& block()
+{
+    thread_local ThreadBlock block;
+    detail::registered = true;
+    return block;
+}
+
+std::uint64_t read(std::uint64_t& value) noexcept
+{
+    return std::atomic_ref{value}.load(std::memory_order_relaxed);
+}
+
+// Bytes written by the process so far, or -1 if the system doesn't say
+long long process_bytes_written()
+{
+    std::ifstream io{"/proc/self/io"};
+    std::string key;
+    long long value = -1;
+    while (io >> key >> value) {
+        if (key == "wchar:")
+            return value;
+    }
+    return -1;
+}
+}
+
+namespace detail {
+constinit thread_local Totals totals{};
+constinit thread_local bool registered = false;
+std::atomic<bool> trace_on{false};
+
+void register_thread()
+{
+    block();
+}
+}
+
+void start_trace()
+{
+    detail::trace_on.store(true, std::memory_order_relaxed);
+}
+
+void trace(const char* const name,
+           const std::chrono::steady_clock::time_point start,
+           const std::chrono::steady_clock::time_point end,
+           const char* const arg_name, const std::uint64_t arg)
+{
+    if (!tracing())
+        return;
+    auto& own = block();
+    std::lock_guard lock{own.events_mutex};
+    if (own.events.size() < max_events)
+        own.events.push_back({name, start, end, arg_name, arg, own.thread});
+}
+
+Span::Span(const char* const name) noexcept
+    : name_{name}, active_{tracing()}
+{
+    if (active_)
+        start_ = std::chrono::steady_clock::now();
+}
+
+Span::~Span()
+{
+    if (active_) {
+        trace(name_, start_, std::chrono::steady_clock::now(), arg_name_,
+              arg_);
+    }
+}
+
+void Span::set_arg(const char* const name, const std::uint64_t value) noexcept
+{
+    arg_name_ = name;
+    arg_ = value;
+}
+
+std::string stats_line()
+{
+    Totals totals;
+    {
+        std::lock_guard lock{registry_mutex};
+        totals = retired;
+        for (ThreadBlock* const other : blocks) {
+            for (std::size_t i = 0; i < num_counters; ++i)
+                totals.counts[i] += read(other->totals.counts[i]);
+            for (std::size_t i = 0; i < num_peaks; ++i) {
+                totals.peaks[i] = std::max(totals.peaks[i],
+                                           read(other->totals.peaks[i]));
+            }
+        }
+    }
+
+    constexpr std::array<const char*, num_counters> counter_names{
+        "actions", "cells_opened", "flood_fills", "flood_cells",
+        "neighbour_lists", "frames", "frame_ns", "cells_redrawn"
+    };
+    constexpr std::array<const char*, num_peaks> peak_names{
+        "max_flood_size", "max_pending"
+    };
+    std::string line;
+    for (std::size_t i = 0; i < num_counters; ++i) {
+        line += counter_names[i];
+        line += '=';
+        line += std::to_string(totals.counts[i]);
+        line += ' ';
+    }
+    for (std::size_t i = 0; i < num_peaks; ++i) {
+        line += peak_names[i];
+        line += '=';
+        line += std::to_string(totals.peaks[i]);
+        line += i + 1 < num_peaks ? " " : "";
+    }
+    if (const long long bytes = process_bytes_written(); bytes >= 0)
+        line += " process_bytes_written=" + std::to_string(bytes);
+    return line;
+}
+
+void write_trace(std::FILE* const out)
+{
+    std::vector<Event> events;
+    {
+        std::lock_guard lock{registry_mutex};
+        events = retired_events;
+        for (ThreadBlock* const other : blocks) {
+            std::lock_guard events_lock{other->events_mutex};
+            events.insert(events.end(), other->events.begin(),
+                          other->events.end());
+        }
+    }
+
+    using us = std::chrono::duration<double, std::micro>;
+    std::fprintf(out, "{\"traceEvents\":[\n");
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const Event& event = events[i];
+        std::fprintf(out,
+                     "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f,\"dur\":%.3f",
+                     event.name, event.thread,
+                     us{event.start - epoch}.count(),
+                     us{event.end - event.start}.count());
+        if (event.arg_name) {
+            std::fprintf(out, ",\"args\":{\"%s\":%llu}", event.arg_name,
+                         static_cast<unsigned long long>(event.arg));
+        }
+        std::fprintf(out, "}%s\n", i + 1 < events.size() ? "," : "");
+    }
+    std::fprintf(out, "]}\n");
+}
+}
+
+#endif
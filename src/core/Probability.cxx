@@ -0,0 +1,574 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Probability.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Game.hxx"
+#include "ThreadPool.hxx"
+
+namespace termmine {
+namespace {
+// Bounds on the logarithm of the tilt, wide enough for any mine count
+// short of filling or emptying every unknown cell
+constexpr double max_log_tilt = 60;
+
+// The product of two polynomials, up to the term of the given degree
+std::vector<double> convolve(const std::vector<double>& a,
+                             const std::vector<double>& b,
+                             const std::size_t max_degree)
+{
+    std::vector<double> result(
+        std::min(a.size() + b.size() - 1, max_degree + 1), 0.0);
+    for (std::size_t i = 0; i < a.size() && i <= max_degree; ++i) {
+        if (a[i] == 0)
+            continue;
+        for (std::size_t j = 0; j < b.size() && i + j <= max_degree; ++j)
+            result[i + j] += a[i] * b[j];
+    }
+    return result;
+}
+
+int find(std::vector<int>& parent, int cell) noexcept
+{
+    while (parent[cell] != cell) {
+        parent[cell] = parent[parent[cell]];
+        cell = parent[cell];
+    }
+    return cell;
+}
+}
+
+ProbabilityEngine::ProbabilityEngine(ThreadPool& pool, const bool use_flags)
+    : pool_{pool}, use_flags_{use_flags}, log_factorial_{0.0} {}
+
+std::vector<double> ProbabilityEngine::compute(const Game& game)
+{
+    const std::atomic<bool> never{false};
+    return compute(game, never);
+}
+
+std::vector<double> ProbabilityEngine::compute(const Game& game,
+                                               const std::atomic<bool>& stop)
+{
+    auto stopped = [&stop] { return stop.load(std::memory_order_relaxed); };
+    const int rows = game.rows();
+    const int cols = game.cols();
+    std::vector<double> probs(rows * cols, 0.0);
+
+    auto unknown = [&game, this](const int row, const int col) {
+        return !game.is_open(row, col)
+            && !(use_flags_ && game.has_flag(row, col));
+    };
+
+    // Every opened number with unknown neighbours is a rule
+    std::vector<std::vector<int>> rules;
+    std::vector<int> rule_mines;
+    std::vector<int> parent(rows * cols, -1);
+    int flags = 0;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            if (!game.is_open(i, j)) {
+                if (!unknown(i, j)) {
+                    probs[i * cols + j] = 1;
+                    ++flags;
+                }
+                continue;
+            }
+
+            std::vector<int> cells;
+            int mines = game.num_adj_mines(i, j);
+            for (int y = std::max(i - 1, 0); y <= std::min(i + 1, rows - 1);
+                 ++y) {
+                for (int x = std::max(j - 1, 0);
+                     x <= std::min(j + 1, cols - 1); ++x) {
+                    if (unknown(y, x))
+                        cells.push_back(y * cols + x);
+                    else if (!game.is_open(y, x))
+                        --mines;
+                }
+            }
+            if (mines < 0 || mines > static_cast<int>(cells.size()))
+                return {};
+            if (cells.empty())
+                continue;
+
+            // Cells sharing a rule belong to the same component
+            for (const int cell : cells) {
+                if (parent[cell] == -1)
+                    parent[cell] = cell;
+            }
+            for (const int cell : cells)
+                parent[find(parent, cell)] = find(parent, cells[0]);
+            rules.push_back(std::move(cells));
+            rule_mines.push_back(mines);
+        }
+    }
+
+    // Group frontier cells and rules by component
+    std::vector<Component> components;
+    std::vector<int> component_of(rows * cols, -1);
+    std::vector<int> local(rows * cols, -1);
+    int interior = 0;
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        if (parent[cell] == -1) {
+            interior += unknown(cell / cols, cell % cols);
+            continue;
+        }
+        int& id = component_of[find(parent, cell)];
+        if (id == -1) {
+            id = components.size();
+            components.emplace_back();
+        }
+        component_of[cell] = id;
+    }
+    for (std::size_t i = 0; i < rules.size(); ++i) {
+        auto& component = components[component_of[rules[i][0]]];
+        for (const int cell : rules[i]) {
+            if (local[cell] == -1) {
+                local[cell] = component.cells.size();
+                component.cells.push_back(cell);
+            }
+        }
+        std::vector<int> rule;
+        for (const int cell : rules[i])
+            rule.push_back(local[cell]);
+        component.rules.push_back(std::move(rule));
+        component.rule_mines.push_back(rule_mines[i]);
+    }
+
+    const int mines_left = game.mines() - flags;
+    if (mines_left < 0)
+        return {};
+    pool_.parallel_for(components.size(), [&components, mines_left, &stop](
+        const std::size_t i) {
+        components[i].enumerate(mines_left, stop);
+    });
+    if (stopped())
+        return {};
+
+    // Every layout is weighed by tilt to the power of its mines, which
+    // scales each total mine count by the same factor and so leaves the
+    // result unchanged. The tilt is picked so that the expected number of
+    // mines under it is the number left, as if each unknown cell held a
+    // mine on its own with odds of tilt. The counts near the mines left,
+    // which carry all the weight, are then the likeliest ones both for the
+    // frontier and for the interior, so none of them is lost to underflow
+    // however many components there are.
+    std::vector<std::vector<double>> log_ways(components.size());
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        for (const double ways : components[i].ways)
+            log_ways[i].push_back(std::log(ways));
+    }
+    std::vector<double> weights;
+    // Expected mines and their variance under a tilt, less the mines left
+    auto expected = [&](const double log_tilt) {
+        double mean = -mines_left;
+        double variance = 0;
+        for (const auto& ways : log_ways) {
+            weights.assign(ways.size(), 0.0);
+            double max = -INFINITY;
+            for (std::size_t k = 0; k < ways.size(); ++k)
+                max = std::max(max, ways[k] + k * log_tilt);
+            double sum = 0;
+            double first = 0;
+            double second = 0;
+            for (std::size_t k = 0; k < ways.size(); ++k) {
+                const double weight = std::exp(ways[k] + k * log_tilt - max);
+                sum += weight;
+                first += weight * k;
+                second += weight * k * k;
+            }
+            mean += first / sum;
+            variance += second / sum - first / sum * (first / sum);
+        }
+        const double odds = 1 / (1 + std::exp(-log_tilt));
+        mean += interior * odds;
+        variance += interior * odds * (1 - odds);
+        return std::pair{mean, variance};
+    };
+    // Newton's method, falling back to bisection when it leaves the bracket
+    double low = -max_log_tilt;
+    double high = max_log_tilt;
+    double log_tilt = mines_left + interior > 0
+        ? std::log(static_cast<double>(mines_left + 1))
+            - std::log(static_cast<double>(interior + 1))
+        : 0;
+    log_tilt = std::clamp(log_tilt, low, high);
+    for (int step = 0; step < 100; ++step) {
+        const auto [excess, variance] = expected(log_tilt);
+        if (std::abs(excess) < 0.5)
+            break;
+        (excess > 0 ? high : low) = log_tilt;
+        const double next = variance > 0 ? log_tilt - excess / variance
+                                         : (low + high) / 2;
+        log_tilt = next > low && next < high ? next : (low + high) / 2;
+    }
+
+    // Tilted, each component's counts are scaled to sum to 1, and its mine
+    // counts along with them
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        auto& component = components[i];
+        const std::size_t size = component.cells.size();
+        double max = -INFINITY;
+        for (std::size_t k = 0; k < log_ways[i].size(); ++k)
+            max = std::max(max, log_ways[i][k] + k * log_tilt);
+        if (max == -INFINITY)
+            return {};
+        double sum = 0;
+        for (std::size_t k = 0; k < log_ways[i].size(); ++k) {
+            const double ways = std::exp(log_ways[i][k] + k * log_tilt - max);
+            for (std::size_t cell = 0; cell < size; ++cell) {
+                double& mine_ways = component.mine_ways[k * size + cell];
+                mine_ways = ways > 0 ? mine_ways / component.ways[k] * ways
+                                     : 0;
+            }
+            component.ways[k] = ways;
+            sum += ways;
+        }
+        for (double& ways : component.ways)
+            ways /= sum;
+        for (double& ways : component.mine_ways)
+            ways /= sum;
+    }
+
+    // The weight of components 0 to i - 1 holding each number of mines is
+    // kept for every stride-th i only, and rebuilt a block at a time on the
+    // way back, so memory grows with the square root of the component
+    // count. Only counts up to the mines left matter, which keeps each step
+    // linear in the component count.
+    const std::size_t count = components.size();
+    const std::size_t max_k = mines_left;
+    const std::size_t stride = std::max<std::size_t>(
+        1, static_cast<std::size_t>(std::sqrt(static_cast<double>(count))));
+    std::vector<std::vector<double>> checkpoints;
+    std::vector<double> total{1.0};
+    for (std::size_t i = 0; i < count; ++i) {
+        if (stopped())
+            return {};
+        if (i % stride == 0)
+            checkpoints.push_back(total);
+        total = convolve(total, components[i].ways, max_k);
+    }
+    total.resize(max_k + 1, 0.0);
+
+    // Layouts of the interior cells for each number of frontier mines,
+    // tilted likewise and scaled so the largest is 1
+    std::vector<double> interior_ways(max_k + 1, -INFINITY);
+    double max_log = -INFINITY;
+    for (std::size_t k = 0; k <= max_k; ++k) {
+        const int rest = mines_left - static_cast<int>(k);
+        if (rest <= interior) {
+            interior_ways[k] = log_choose(interior, rest) + rest * log_tilt;
+            max_log = std::max(max_log, interior_ways[k]);
+        }
+    }
+    if (max_log == -INFINITY)
+        return {};
+    for (double& ways : interior_ways)
+        ways = std::exp(ways - max_log);
+
+    double weight = 0;
+    double interior_mines = 0;
+    for (std::size_t k = 0; k <= max_k; ++k) {
+        weight += total[k] * interior_ways[k];
+        interior_mines += total[k] * interior_ways[k]
+            * (mines_left - static_cast<int>(k));
+    }
+    if (!(weight > 0) || !std::isfinite(weight))
+        return {};
+
+    // after[k] is the weight of the components after the current one and
+    // the interior, given k mines in the components up to it. Going back
+    // from the last component, each one's mine counts are weighed against
+    // the components before it and everything after.
+    std::vector<double> after{interior_ways};
+    std::vector<double> next(max_k + 1);
+    std::vector<std::vector<double>> before;
+    for (std::size_t i = count; i-- > 0;) {
+        if (stopped())
+            return {};
+        const std::size_t first = i / stride * stride;
+        if (i == count - 1 || i % stride == stride - 1) {
+            before.assign(1, checkpoints[i / stride]);
+            for (std::size_t j = first; j < i; ++j)
+                before.push_back(convolve(before.back(), components[j].ways,
+                                          max_k));
+        }
+        const auto& prefix = before[i - first];
+        const auto& component = components[i];
+        const std::size_t size = component.cells.size();
+
+        for (std::size_t a = 0; a < component.ways.size() && a <= max_k; ++a) {
+            double rest = 0;
+            for (std::size_t b = 0; b < prefix.size() && a + b <= max_k; ++b)
+                rest += prefix[b] * after[a + b];
+            if (rest == 0)
+                continue;
+
+            for (std::size_t cell = 0; cell < size; ++cell) {
+                probs[component.cells[cell]]
+                    += component.mine_ways[a * size + cell] * rest / weight;
+            }
+        }
+
+        for (std::size_t k = 0; k <= max_k; ++k) {
+            double ways = 0;
+            for (std::size_t a = 0;
+                 a < component.ways.size() && k + a <= max_k; ++a)
+                ways += component.ways[a] * after[k + a];
+            next[k] = ways;
+        }
+        after.swap(next);
+    }
+
+    if (interior > 0) {
+        const double interior_prob = interior_mines / weight / interior;
+        for (int cell = 0; cell < rows * cols; ++cell) {
+            if (parent[cell] == -1 && unknown(cell / cols, cell % cols))
+                probs[cell] = interior_prob;
+        }
+    }
+    return probs;
+}
+
+void ProbabilityEngine::Component::enumerate(const int max_mines,
+                                             const std::atomic<bool>& stop)
+{
+    const int size = cells.size();
+    std::vector<std::vector<int>> cell_rules(size);
+    for (std::size_t i = 0; i < rules.size(); ++i) {
+        for (const int cell : rules[i])
+            cell_rules[cell].push_back(i);
+    }
+
+    // Cells touched by exactly the same rules are interchangeable, so only
+    // the number of mines in each such group has to be enumerated
+    struct Group {
+        std::vector<int> cells;
+        std::vector<int> rules;
+    };
+    std::vector<Group> groups;
+    std::vector<int> group_of(size, -1);
+    for (int cell = 0; cell < size; ++cell) {
+        std::sort(cell_rules[cell].begin(), cell_rules[cell].end());
+        for (int other = 0; other < cell && group_of[cell] == -1; ++other) {
+            if (cell_rules[other] == cell_rules[cell])
+                group_of[cell] = group_of[other];
+        }
+        if (group_of[cell] == -1) {
+            group_of[cell] = groups.size();
+            groups.push_back({{}, cell_rules[cell]});
+        }
+        groups[group_of[cell]].cells.push_back(cell);
+    }
+
+    // Visit groups breadth first through their rules, which keeps each
+    // rule's groups close together so that broken rules are noticed early
+    std::vector<std::vector<int>> rule_groups(rules.size());
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        for (const int rule : groups[i].rules)
+            rule_groups[rule].push_back(i);
+    }
+    std::vector<int> order{0};
+    std::vector<char> seen(groups.size(), 0);
+    seen[0] = 1;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (const int rule : groups[order[i]].rules) {
+            for (const int group : rule_groups[rule]) {
+                if (!seen[group]) {
+                    seen[group] = 1;
+                    order.push_back(group);
+                }
+            }
+        }
+    }
+
+    // Mines still needed by and cells still unassigned in each rule
+    std::vector<int> needed{rule_mines};
+    std::vector<int> open(rules.size());
+    for (std::size_t i = 0; i < rules.size(); ++i)
+        open[i] = rules[i].size();
+
+    const int num_groups = groups.size();
+    std::vector<int> group_mines(num_groups, 0);
+    std::vector<double> group_ways((size + 1) * num_groups, 0.0);
+    ways.assign(size + 1, 0.0);
+
+    auto assign = [&](auto& self, const int index, const int mines,
+                      const double layouts) -> void {
+        if (stop.load(std::memory_order_relaxed))
+            return;
+        if (index == num_groups) {
+            ways[mines] += layouts;
+            for (int i = 0; i < num_groups; ++i)
+                group_ways[mines * num_groups + i] += layouts * group_mines[i];
+            return;
+        }
+
+        const auto& group = groups[order[index]];
+        const int group_size = group.cells.size();
+        double choices = 1; // ways to pick the group's mines among its cells
+        for (int count = 0; count <= group_size; ++count) {
+            if (mines + count > max_mines)
+                break;
+
+            bool valid = true;
+            for (const int rule : group.rules) {
+                valid = valid && needed[rule] >= count
+                    && needed[rule] - count <= open[rule] - group_size;
+            }
+            if (valid) {
+                for (const int rule : group.rules) {
+                    needed[rule] -= count;
+                    open[rule] -= group_size;
+                }
+                group_mines[order[index]] = count;
+                self(self, index + 1, mines + count, layouts * choices);
+                for (const int rule : group.rules) {
+                    needed[rule] += count;
+                    open[rule] += group_size;
+                }
+            }
+            choices = choices * (group_size - count) / (count + 1);
+        }
+        group_mines[order[index]] = 0;
+    };
+    assign(assign, 0, 0, 1.0);
+
+    // Mines in a group are spread evenly over its cells
+    mine_ways.assign((size + 1) * size, 0.0);
+    for (int mines = 0; mines <= size; ++mines) {
+        for (int cell = 0; cell < size; ++cell) {
+            const auto& group = groups[group_of[cell]];
+            mine_ways[mines * size + cell]
+                = group_ways[mines * num_groups + group_of[cell]]
+                / group.cells.size();
+        }
+    }
+}
+
+double ProbabilityEngine::log_choose(const int n, const int k)
+{
+    while (log_factorial_.size() <= static_cast<std::size_t>(n)) {
+        log_factorial_.push_back(log_factorial_.back()
+            + std::log(static_cast<double>(log_factorial_.size())));
+    }
+    return log_factorial_[n] - log_factorial_[k] - log_factorial_[n - k];
+}
+
+std::vector<double> estimate_probabilities(const Game& game,
+                                           const bool use_flags)
+{
+    const int rows = game.rows();
+    const int cols = game.cols();
+    auto unknown = [&game, use_flags](const int row, const int col) {
+        return !game.is_open(row, col)
+            && !(use_flags && game.has_flag(row, col));
+    };
+
+    int unknown_cells = 0;
+    int flags = 0;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            unknown_cells += unknown(i, j);
+            flags += !game.is_open(i, j) && !unknown(i, j);
+        }
+    }
+    const double density = unknown_cells > 0
+        ? static_cast<double>(game.mines() - flags) / unknown_cells : 0;
+
+    // Negative until a number touches the cell
+    std::vector<double> probs(rows * cols, -1.0);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            if (!game.is_open(i, j)) {
+                if (!unknown(i, j))
+                    probs[i * cols + j] = 1;
+                continue;
+            }
+
+            int cells = 0;
+            int mines = game.num_adj_mines(i, j);
+            for (int y = std::max(i - 1, 0); y <= std::min(i + 1, rows - 1);
+                 ++y) {
+                for (int x = std::max(j - 1, 0);
+                     x <= std::min(j + 1, cols - 1); ++x) {
+                    if (unknown(y, x))
+                        ++cells;
+                    else if (!game.is_open(y, x))
+                        --mines;
+                }
+            }
+            if (cells == 0)
+                continue;
+
+            const double local = std::clamp(
+                static_cast<double>(mines) / cells, 0.0, 1.0);
+            for (int y = std::max(i - 1, 0); y <= std::min(i + 1, rows - 1);
+                 ++y) {
+                for (int x = std::max(j - 1, 0);
+                     x <= std::min(j + 1, cols - 1); ++x) {
+                    if (unknown(y, x))
+                        probs[y * cols + x] = std::max(probs[y * cols + x],
+                                                       local);
+                }
+            }
+        }
+    }
+
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        if (game.is_open(cell / cols, cell % cols))
+            probs[cell] = 0;
+        else if (probs[cell] < 0)
+            probs[cell] = density;
+    }
+    return probs;
+}
+
+std::optional<std::pair<int, int>> safest_cell(const Game& game,
+                                               const std::vector<double>& probs)
+{
+    std::optional<std::pair<int, int>> best;
+    double best_prob = 2;
+    for (int i = 0; i < game.rows(); ++i) {
+        for (int j = 0; j < game.cols(); ++j) {
+            const double prob = probs[i * game.cols() + j];
+            if (!game.is_open(i, j) && !game.has_flag(i, j)
+                && prob < best_prob) {
+                best = {i, j};
+                best_prob = prob;
+            }
+        }
+    }
+    return best;
+}
+}
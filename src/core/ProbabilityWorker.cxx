@@ -0,0 +1,110 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "ProbabilityWorker.hxx"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "Game.hxx"
+
+namespace termmine {
+ProbabilityWorker::ProbabilityWorker()
+    : engine_{pool_, false}, thread_{&ProbabilityWorker::work, this} {}
+
+ProbabilityWorker::~ProbabilityWorker()
+{
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+        stale_.store(true, std::memory_order_relaxed);
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+void ProbabilityWorker::request(const Game& game)
+{
+    const std::size_t generation = game.changes().size();
+    if (generation == requested_)
+        return;
+    requested_ = generation;
+
+    auto snapshot = std::make_unique<const Game>(game);
+    {
+        std::lock_guard lock{mutex_};
+        next_ = std::move(snapshot);
+        stale_.store(true, std::memory_order_relaxed);
+    }
+    wake_.notify_one();
+}
+
+bool ProbabilityWorker::busy() const noexcept
+{
+    return finished_.load(std::memory_order_relaxed) != requested_;
+}
+
+bool ProbabilityWorker::poll() noexcept
+{
+    return results_.update();
+}
+
+const ProbabilityWorker::Result& ProbabilityWorker::result() const noexcept
+{
+    return results_.front();
+}
+
+bool ProbabilityWorker::fresh(const Game& game) const noexcept
+{
+    return results_.front().generation == game.changes().size();
+}
+
+void ProbabilityWorker::work()
+{
+    while (true) {
+        std::unique_ptr<const Game> game;
+        {
+            std::unique_lock lock{mutex_};
+            wake_.wait(lock, [this] { return stopping_ || next_; });
+            if (stopping_)
+                return;
+            game = std::move(next_);
+            stale_.store(false, std::memory_order_relaxed);
+        }
+
+        // A newer request or the destructor stops the engine early, and
+        // whatever it had is dropped rather than published
+        const std::size_t generation = game->changes().size();
+        auto probs = engine_.compute(*game, stale_);
+        if (stale_.load(std::memory_order_relaxed))
+            continue;
+        auto& result = results_.back();
+        result.generation = generation;
+        result.probs = std::move(probs);
+        results_.publish();
+        finished_.store(generation, std::memory_order_relaxed);
+    }
+}
+}
@@ -0,0 +1,222 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Replay.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "FileFormat.hxx"
+#include "Game.hxx"
+
+namespace termmine {
+namespace {
+constexpr char magic[4]{'T', 'M', 'R', 'P'};
+constexpr unsigned char version = 1;
+constexpr unsigned end_tag = 7;
+
+std::uint64_t zigzag(const std::int64_t value) noexcept
+{
+    return static_cast<std::uint64_t>(value) << 1 ^ (value < 0 ? ~0ull : 0);
+}
+
+std::int64_t unzigzag(const std::uint64_t value) noexcept
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(
+        value & 1);
+}
+}
+
+void apply_action(Game& game, const Action action, const int row,
+                  const int col)
+{
+    switch (action) {
+    case Action::open:
+        game.open_cell(row, col);
+        game.check_win(row, col);
+        break;
+    case Action::chord:
+        game.chord_cell(row, col);
+        game.check_win(row, col);
+        break;
+    case Action::flag:
+        game.flag_cell(row, col);
+        break;
+    case Action::mark:
+        game.mark_cell(row, col);
+        break;
+    }
+}
+
+ReplayWriter::ReplayWriter(const std::string& path, const Game& game)
+    : ReplayWriter{path, ReplayHeader{game.rows(), game.cols(), game.mines(),
+                                      game.seed()}}
+{
+}
+
+ReplayWriter::ReplayWriter(const std::string& path,
+                           const ReplayHeader& header)
+    : cols_{header.cols},
+      file_{std::fopen(path.c_str(), "wb")},
+      buffer_(buffer_size)
+{
+    if (!file_)
+        return;
+    std::setvbuf(file_, buffer_.data(), _IOFBF, buffer_.size());
+
+    std::fwrite(magic, 1, sizeof(magic), file_);
+    std::fputc(version, file_);
+    put_varint(header.rows);
+    put_varint(header.cols);
+    put_varint(header.mines);
+    put_varint(header.seed);
+}
+
+ReplayWriter::~ReplayWriter()
+{
+    if (file_)
+        std::fclose(file_);
+}
+
+bool ReplayWriter::good() const noexcept
+{
+    return file_;
+}
+
+void ReplayWriter::record(const Action action, const int row, const int col,
+                          const std::int64_t time)
+{
+    if (!file_)
+        return;
+    const int cell = row * cols_ + col;
+    put_varint(zigzag(cell - last_cell_) << 3
+        | static_cast<unsigned>(action));
+    put_varint(time - last_time_);
+    last_cell_ = cell;
+    last_time_ = time;
+}
+
+std::int64_t ReplayWriter::last_time() const noexcept
+{
+    return last_time_;
+}
+
+void ReplayWriter::finish(const bool won, const std::int64_t time)
+{
+    if (!file_)
+        return;
+    put_varint(end_tag);
+    put_varint(time - last_time_);
+    std::fputc(won, file_);
+    file_format::sync(file_);
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void ReplayWriter::put_varint(std::uint64_t value)
+{
+    while (value >= 0x80) {
+        std::fputc(static_cast<unsigned char>(value | 0x80), file_);
+        value >>= 7;
+    }
+    std::fputc(static_cast<unsigned char>(value), file_);
+}
+
+ReplayReader::ReplayReader(const unsigned char* const data,
+                           const std::size_t size)
+    : pos_{data}, end_of_data_{data + size}
+{
+    if (size < sizeof(magic) + 1 || std::memcmp(data, magic, sizeof(magic)))
+        throw BadReplay{"Not a replay file"};
+    if (data[sizeof(magic)] != version)
+        throw BadReplay{"Unsupported replay version"};
+    pos_ += sizeof(magic) + 1;
+
+    header_.rows = static_cast<int>(get_varint());
+    header_.cols = static_cast<int>(get_varint());
+    header_.mines = static_cast<int>(get_varint());
+    header_.seed = get_varint();
+    const std::int64_t cells = std::int64_t{header_.rows} * header_.cols;
+    if (header_.rows <= 0 || header_.cols <= 0 || header_.mines < 0
+        || cells > std::numeric_limits<int>::max() || header_.mines >= cells)
+        throw BadReplay{"Invalid board size in replay"};
+}
+
+const ReplayHeader& ReplayReader::header() const noexcept
+{
+    return header_;
+}
+
+std::optional<ReplayEvent> ReplayReader::next()
+{
+    if (end_)
+        return std::nullopt;
+
+    const std::uint64_t tag = get_varint();
+    const std::int64_t time = last_time_ + static_cast<std::int64_t>(
+        get_varint());
+    if ((tag & 7) == end_tag) {
+        if (pos_ == end_of_data_)
+            throw BadReplay{"Truncated replay"};
+        end_ = ReplayEnd{*pos_++ != 0, time};
+        return std::nullopt;
+    }
+    if ((tag & 7) > static_cast<unsigned>(Action::mark))
+        throw BadReplay{"Unknown action in replay"};
+
+    const std::int64_t cell = last_cell_ + unzigzag(tag >> 3);
+    if (cell < 0 || cell >= header_.rows * header_.cols)
+        throw BadReplay{"Cell out of range in replay"};
+    last_cell_ = static_cast<int>(cell);
+    last_time_ = time;
+    return ReplayEvent{static_cast<Action>(tag & 7), last_cell_ / header_.cols,
+                       last_cell_ % header_.cols, time};
+}
+
+const std::optional<ReplayEnd>& ReplayReader::end() const noexcept
+{
+    return end_;
+}
+
+std::uint64_t ReplayReader::get_varint()
+{
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos_ == end_of_data_)
+            throw BadReplay{"Truncated replay"};
+        const unsigned char byte = *pos_++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw BadReplay{"Malformed number in replay"};
+}
+}
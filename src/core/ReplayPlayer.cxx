@@ -0,0 +1,139 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "ReplayPlayer.hxx"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "Game.hxx"
+#include "Replay.hxx"
+
+namespace termmine {
+ReplayPlayer::ReplayPlayer(ReplayReader reader)
+    : header_{reader.header()}
+{
+    while (const auto event = reader.next())
+        events_.push_back(*event);
+    end_ = reader.end();
+
+    // Few enough copies to keep memory in check on huge boards, and few
+    // enough moves between them that seeking stays instant
+    constexpr std::size_t min_interval = 64;
+    constexpr std::size_t max_keyframes = 32;
+    interval_ = std::max(min_interval, events_.size() / max_keyframes + 1);
+
+    game_.emplace(header_.rows, header_.cols, header_.mines, header_.seed);
+    keyframes_.push_back(*game_);
+    while (step()) {
+        if (position_ % interval_ == 0)
+            keyframes_.push_back(*game_);
+    }
+    seek(0);
+}
+
+const Game& ReplayPlayer::game() const noexcept
+{
+    return *game_;
+}
+
+const ReplayHeader& ReplayPlayer::header() const noexcept
+{
+    return header_;
+}
+
+const std::optional<ReplayEnd>& ReplayPlayer::end() const noexcept
+{
+    return end_;
+}
+
+std::size_t ReplayPlayer::position() const noexcept
+{
+    return position_;
+}
+
+std::size_t ReplayPlayer::size() const noexcept
+{
+    return events_.size();
+}
+
+const ReplayEvent* ReplayPlayer::last() const noexcept
+{
+    return position_ > 0 ? &events_[position_ - 1] : nullptr;
+}
+
+std::int64_t ReplayPlayer::time() const noexcept
+{
+    return position_ > 0 ? events_[position_ - 1].time : 0;
+}
+
+std::int64_t ReplayPlayer::next_time() const noexcept
+{
+    return position_ < events_.size() ? events_[position_].time
+        : duration();
+}
+
+std::int64_t ReplayPlayer::duration() const noexcept
+{
+    if (end_)
+        return end_->time;
+    return events_.empty() ? 0 : events_.back().time;
+}
+
+bool ReplayPlayer::step()
+{
+    if (position_ == events_.size())
+        return false;
+    const ReplayEvent& event = events_[position_++];
+    apply_action(*game_, event.action, event.row, event.col);
+    return true;
+}
+
+void ReplayPlayer::seek(std::size_t position)
+{
+    position = std::min(position, events_.size());
+    // Moving forward a little is cheaper than restoring a keyframe
+    if (position < position_ || position - position_ >= interval_) {
+        const std::size_t keyframe = position / interval_;
+        game_.emplace(keyframes_[keyframe]);
+        position_ = keyframe * interval_;
+    }
+    while (position_ < position)
+        step();
+}
+
+void ReplayPlayer::seek_time(const std::int64_t time)
+{
+    const auto after = std::upper_bound(
+        events_.begin(), events_.end(), time,
+        [](const std::int64_t t, const ReplayEvent& event) {
+            return t < event.time;
+        });
+    seek(after - events_.begin());
+}
+}
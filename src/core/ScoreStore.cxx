@@ -0,0 +1,315 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "ScoreStore.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "FileFormat.hxx"
+
+namespace termmine {
+using namespace file_format;
+
+namespace {
+/*
+* The log is a 16 byte header of the magic "TMSL" and a version byte, then
+* 32 byte records: rows and cols as 16 bits, mines, the time in milliseconds,
+* the seed, 3BV, a byte with 1 for a win and 2 for a no-guess board, and an
+* FNV-1a checksum of the rest. Numbers are little-endian.
+*
+* The index is the magic "TMSI", a version byte, the number of log records
+* it covers and its number of entries, then a 36 byte entry per kind of
+* board, and a checksum of it all.
+*/
+constexpr char log_magic[4]{'T', 'M', 'S', 'L'};
+constexpr char index_magic[4]{'T', 'M', 'S', 'I'};
+constexpr unsigned char version = 1;
+constexpr long log_header_size = 16;
+constexpr long record_size = 32;
+constexpr std::size_t index_header_size = 20;
+constexpr std::size_t entry_size = 36;
+constexpr std::uint32_t no_time = ~std::uint32_t{0};
+
+std::uint32_t clamp_time(const std::int64_t time) noexcept
+{
+    return static_cast<std::uint32_t>(std::clamp<std::int64_t>(time, 0,
+                                                               no_time - 1));
+}
+
+void encode(const GameRecord& game, unsigned char* const out) noexcept
+{
+    std::memset(out, 0, record_size);
+    put16(out, game.rows);
+    put16(out + 2, game.cols);
+    put32(out + 4, game.mines);
+    put32(out + 8, clamp_time(game.time));
+    put64(out + 12, game.seed);
+    put32(out + 20, game.bbbv);
+    out[24] = game.won | game.no_guess << 1;
+    put32(out + 28, checksum(out, 28));
+}
+
+std::optional<GameRecord> decode(const unsigned char* const in) noexcept
+{
+    if (get32(in + 28) != checksum(in, 28))
+        return std::nullopt;
+    return GameRecord{static_cast<int>(get16(in)),
+                      static_cast<int>(get16(in + 2)),
+                      static_cast<int>(get32(in + 4)), (in[24] & 2) != 0,
+                      get64(in + 12), get32(in + 8),
+                      static_cast<int>(get32(in + 20)), (in[24] & 1) != 0};
+}
+
+std::uint64_t records_in(const long size) noexcept
+{
+    return size < log_header_size ? 0 : (size - log_header_size) / record_size;
+}
+}
+
+ScoreStore::ScoreStore(const std::string& dir)
+{
+    if (dir.empty())
+        return;
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    const auto log_path = std::filesystem::path{dir} / "games.log";
+    index_path_ = (std::filesystem::path{dir} / "games.idx").string();
+
+    // Some other program's or version's log is left alone rather than cut
+    // to a record boundary. A header a crash cut short only has to match
+    // as far as it goes.
+    unsigned char header[log_header_size]{};
+    std::memcpy(header, log_magic, sizeof(log_magic));
+    header[sizeof(log_magic)] = version;
+    if (std::FILE* const existing = std::fopen(log_path.string().c_str(),
+                                               "rb")) {
+        unsigned char found[sizeof(log_magic) + 1];
+        const std::size_t read = std::fread(found, 1, sizeof(found),
+                                            existing);
+        std::fclose(existing);
+        if (std::memcmp(found, header, read))
+            return;
+    }
+
+    // Cut off a header or record left half-written by a crash
+    const auto size = std::filesystem::file_size(log_path, ec);
+    if (!ec && size < static_cast<std::uintmax_t>(log_header_size)) {
+        std::filesystem::resize_file(log_path, 0, ec);
+    } else if (!ec && (size - log_header_size) % record_size) {
+        std::filesystem::resize_file(
+            log_path, size - (size - log_header_size) % record_size, ec);
+    }
+
+    log_ = std::fopen(log_path.string().c_str(), "a+b");
+    if (!log_)
+        return;
+    std::fseek(log_, 0, SEEK_END);
+    if (std::ftell(log_) == 0) {
+        std::fwrite(header, 1, sizeof(header), log_);
+        sync(log_);
+    }
+
+    // Without a usable index, every record is counted again
+    if (!load_index()) {
+        scores_.clear();
+        records_ = 0;
+    }
+    if (catch_up())
+        save_index();
+}
+
+ScoreStore::~ScoreStore()
+{
+    if (log_)
+        std::fclose(log_);
+}
+
+bool ScoreStore::good() const noexcept
+{
+    return log_;
+}
+
+bool ScoreStore::add(const GameRecord& game)
+{
+    if (!log_ || game.rows > 0xffff || game.cols > 0xffff)
+        return false;
+    const BoardScores* const before = scores(game.rows, game.cols,
+                                             game.mines, game.no_guess);
+    const std::optional<std::int64_t> best = before && before->best
+        ? std::optional{before->best->time} : std::nullopt;
+
+    unsigned char record[record_size];
+    encode(game, record);
+    std::fseek(log_, 0, SEEK_END);
+    if (std::fwrite(record, 1, sizeof(record), log_) != sizeof(record))
+        return false;
+    sync(log_);
+    // Counts this record along with any other process's
+    catch_up();
+    save_index();
+    return game.won && (!best || clamp_time(game.time) < *best);
+}
+
+const BoardScores* ScoreStore::scores(const int rows, const int cols,
+                                      const int mines, const bool no_guess)
+    const noexcept
+{
+    const auto it = scores_.find(Key{rows, cols, mines, no_guess});
+    return it == scores_.end() ? nullptr : &it->second;
+}
+
+void ScoreStore::apply(const GameRecord& game)
+{
+    BoardScores& board = scores_[Key{game.rows, game.cols, game.mines,
+                                     game.no_guess}];
+    ++board.games;
+    if (!game.won)
+        return;
+    ++board.wins;
+    if (!board.best || game.time < board.best->time)
+        board.best = game;
+}
+
+bool ScoreStore::catch_up()
+{
+    std::fseek(log_, 0, SEEK_END);
+    const std::uint64_t total = records_in(std::ftell(log_));
+    if (total <= records_)
+        return false;
+
+    std::fseek(log_, log_header_size + records_ * record_size, SEEK_SET);
+    std::vector<unsigned char> buffer(record_size * 1024);
+    while (records_ < total) {
+        const std::size_t count = std::min<std::uint64_t>(
+            total - records_, buffer.size() / record_size);
+        const std::size_t read = std::fread(buffer.data(), record_size, count,
+                                            log_);
+        // Records that fail their checksum are skipped
+        for (std::size_t i = 0; i < read; ++i) {
+            if (const auto game = decode(buffer.data() + i * record_size))
+                apply(*game);
+        }
+        records_ += read;
+        if (read < count)
+            break;
+    }
+    return true;
+}
+
+bool ScoreStore::load_index()
+{
+    std::FILE* const file = std::fopen(index_path_.c_str(), "rb");
+    if (!file)
+        return false;
+    std::vector<unsigned char> data;
+    unsigned char chunk[4096];
+    for (std::size_t read; (read = std::fread(chunk, 1, sizeof(chunk), file));)
+        data.insert(data.end(), chunk, chunk + read);
+    std::fclose(file);
+
+    if (data.size() < index_header_size + 4
+        || std::memcmp(data.data(), index_magic, sizeof(index_magic))
+        || data[sizeof(index_magic)] != version
+        || get32(data.data() + data.size() - 4)
+            != checksum(data.data(), data.size() - 4))
+        return false;
+    const std::uint64_t records = get64(data.data() + 8);
+    const std::uint32_t entries = get32(data.data() + 16);
+    if (data.size() != index_header_size + entries * entry_size + 4)
+        return false;
+    // An index ahead of the log was written for some other log
+    std::fseek(log_, 0, SEEK_END);
+    if (records > records_in(std::ftell(log_)))
+        return false;
+
+    for (std::uint32_t i = 0; i < entries; ++i) {
+        const unsigned char* const entry = data.data() + index_header_size
+            + i * entry_size;
+        const int rows = get16(entry);
+        const int cols = get16(entry + 2);
+        const int mines = get32(entry + 4);
+        const bool no_guess = entry[8];
+        BoardScores& board = scores_[Key{rows, cols, mines, no_guess}];
+        board.games = get32(entry + 12);
+        board.wins = get32(entry + 16);
+        if (get32(entry + 20) != no_time) {
+            board.best = GameRecord{rows, cols, mines, no_guess,
+                                    get64(entry + 28), get32(entry + 20),
+                                    static_cast<int>(get32(entry + 24)),
+                                    true};
+        }
+    }
+    records_ = records;
+    return true;
+}
+
+// Writes a new index beside the old one and renames it over, so the index
+// on disk is always whole
+void ScoreStore::save_index() const
+{
+    std::vector<unsigned char> data(index_header_size
+                                    + scores_.size() * entry_size + 4);
+    std::memcpy(data.data(), index_magic, sizeof(index_magic));
+    data[sizeof(index_magic)] = version;
+    put64(data.data() + 8, records_);
+    put32(data.data() + 16, scores_.size());
+    unsigned char* entry = data.data() + index_header_size;
+    for (const auto& [key, board] : scores_) {
+        const auto& [rows, cols, mines, no_guess] = key;
+        put16(entry, rows);
+        put16(entry + 2, cols);
+        put32(entry + 4, mines);
+        entry[8] = no_guess;
+        put32(entry + 12, board.games);
+        put32(entry + 16, board.wins);
+        put32(entry + 20, board.best ? clamp_time(board.best->time) : no_time);
+        put32(entry + 24, board.best ? board.best->bbbv : 0);
+        put64(entry + 28, board.best ? board.best->seed : 0);
+        entry += entry_size;
+    }
+    put32(entry, checksum(data.data(), data.size() - 4));
+
+    const std::string temp_path = index_path_ + ".tmp";
+    std::FILE* const file = std::fopen(temp_path.c_str(), "wb");
+    if (!file)
+        return;
+    const bool written = std::fwrite(data.data(), 1, data.size(), file)
+        == data.size();
+    sync(file);
+    std::fclose(file);
+    std::error_code ec;
+    if (written)
+        std::filesystem::rename(temp_path, index_path_, ec);
+}
+}
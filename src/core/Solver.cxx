@@ -0,0 +1,285 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "Solver.hxx"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Game.hxx"
+
+namespace termmine {
+bool Solver::Constraint::contains(const int cell) const noexcept
+{
+    return std::find(cells.begin(), cells.begin() + size, cell)
+        != cells.begin() + size;
+}
+
+bool Solver::Constraint::subset_of(const Constraint& other) const noexcept
+{
+    if (size > other.size)
+        return false;
+    return std::all_of(cells.begin(), cells.begin() + size,
+                       [&other](const int cell) {
+                           return other.contains(cell);
+                       });
+}
+
+Solver::Solver(const Game& game, const bool use_flags)
+    : game_{game},
+      use_flags_{use_flags},
+      rows_{game.rows()},
+      cols_{game.cols()}
+{
+    rebuild();
+}
+
+void Solver::update()
+{
+    const auto& changes = game_.changes();
+    for (; seen_changes_ < changes.size(); ++seen_changes_) {
+        const int cell = changes[seen_changes_];
+        const int row = cell / cols_;
+        const int col = cell % cols_;
+
+        if (game_.is_open(row, col)) {
+            if (!constraints_[cell].active)
+                open(cell);
+        } else if (!use_flags_) {
+            continue;
+        } else if (game_.has_flag(row, col)) {
+            if (known_[cell] == Knowledge::unknown)
+                set_mine(cell, Knowledge::flagged);
+        } else if (known_[cell] == Knowledge::flagged) {
+            // Deductions may have relied on the removed flag
+            rebuild();
+            return;
+        }
+    }
+    propagate();
+}
+
+bool Solver::is_safe(const int row, const int col) const noexcept
+{
+    return known_[row * cols_ + col] == Knowledge::safe;
+}
+
+bool Solver::is_mine(const int row, const int col) const noexcept
+{
+    return known_[row * cols_ + col] == Knowledge::mine
+        || known_[row * cols_ + col] == Knowledge::flagged;
+}
+
+std::optional<std::pair<int, int>> Solver::next_safe()
+{
+    while (!safe_.empty()) {
+        const int cell = safe_.back();
+        if (!game_.is_open(cell / cols_, cell % cols_))
+            return std::pair{cell / cols_, cell % cols_};
+        safe_.pop_back();
+    }
+    return std::nullopt;
+}
+
+int Solver::safe_found() const noexcept
+{
+    return safe_found_;
+}
+
+int Solver::mines_found() const noexcept
+{
+    return mines_found_;
+}
+
+template <typename Func>
+void Solver::for_each_adjacent(const int cell, const int radius, Func&& func)
+    const
+{
+    const int row = cell / cols_;
+    const int col = cell % cols_;
+    for (int i = std::max(row - radius, 0);
+         i <= std::min(row + radius, rows_ - 1); ++i) {
+        for (int j = std::max(col - radius, 0);
+             j <= std::min(col + radius, cols_ - 1); ++j) {
+            if (i != row || j != col)
+                func(i * cols_ + j);
+        }
+    }
+}
+
+void Solver::rebuild()
+{
+    known_.assign(rows_ * cols_, Knowledge::unknown);
+    constraints_.assign(rows_ * cols_, Constraint{});
+    queue_.clear();
+    safe_.clear();
+    safe_found_ = 0;
+    mines_found_ = 0;
+
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < cols_; ++j) {
+            if (use_flags_ && game_.has_flag(i, j))
+                set_mine(i * cols_ + j, Knowledge::flagged);
+        }
+    }
+    for (int i = 0; i < rows_; ++i) {
+        for (int j = 0; j < cols_; ++j) {
+            if (game_.is_open(i, j))
+                open(i * cols_ + j);
+        }
+    }
+    seen_changes_ = game_.changes().size();
+    propagate();
+}
+
+void Solver::open(const int cell)
+{
+    if (known_[cell] != Knowledge::safe) {
+        known_[cell] = Knowledge::safe;
+        resolve(cell, false);
+    }
+
+    auto& constraint = constraints_[cell];
+    constraint.active = true;
+    constraint.size = 0;
+    constraint.mines = game_.num_adj_mines(cell / cols_, cell % cols_);
+    for_each_adjacent(cell, 1, [this, &constraint](const int adj) {
+        if (known_[adj] == Knowledge::unknown)
+            constraint.cells[constraint.size++] = adj;
+        else if (known_[adj] != Knowledge::safe)
+            --constraint.mines;
+    });
+    enqueue(cell);
+}
+
+void Solver::set_safe(const int cell)
+{
+    if (known_[cell] != Knowledge::unknown)
+        return;
+
+    known_[cell] = Knowledge::safe;
+    safe_.push_back(cell);
+    ++safe_found_;
+    resolve(cell, false);
+}
+
+void Solver::set_mine(const int cell, const Knowledge how)
+{
+    if (known_[cell] != Knowledge::unknown)
+        return;
+
+    known_[cell] = how;
+    if (how == Knowledge::mine)
+        ++mines_found_;
+    resolve(cell, true);
+}
+
+void Solver::resolve(const int cell, const bool mine)
+{
+    for_each_adjacent(cell, 1, [this, cell, mine](const int adj) {
+        auto& constraint = constraints_[adj];
+        if (!constraint.active)
+            return;
+
+        const auto end = constraint.cells.begin() + constraint.size;
+        const auto it = std::find(constraint.cells.begin(), end, cell);
+        if (it == end)
+            return;
+        *it = *(end - 1);
+        --constraint.size;
+        constraint.mines -= mine;
+        enqueue(adj);
+    });
+}
+
+void Solver::enqueue(const int cell)
+{
+    if (!constraints_[cell].queued) {
+        constraints_[cell].queued = true;
+        queue_.push_back(cell);
+    }
+}
+
+void Solver::propagate()
+{
+    std::vector<int> safe;
+    std::vector<int> mines;
+    while (!queue_.empty()) {
+        const int cell = queue_.back();
+        queue_.pop_back();
+        auto& constraint = constraints_[cell];
+        constraint.queued = false;
+        if (constraint.size == 0)
+            continue;
+
+        safe.clear();
+        mines.clear();
+
+        // Single point: the number alone decides all unknown neighbours
+        const auto begin = constraint.cells.begin();
+        if (constraint.mines == 0)
+            safe.assign(begin, begin + constraint.size);
+        else if (constraint.mines == constraint.size)
+            mines.assign(begin, begin + constraint.size);
+
+        // Subset: if one constraint's cells are all in another, the cells
+        // only in the larger one hold the difference in mines
+        if (safe.empty() && mines.empty()) {
+            for_each_adjacent(cell, 2, [&](const int other_cell) {
+                const auto& other = constraints_[other_cell];
+                if (other.size == 0)
+                    return;
+
+                const Constraint* small = &constraint;
+                const Constraint* large = &other;
+                if (!small->subset_of(*large)) {
+                    std::swap(small, large);
+                    if (!small->subset_of(*large))
+                        return;
+                }
+                if (small->size == large->size)
+                    return;
+
+                const int extra_mines = large->mines - small->mines;
+                const int extra_cells = large->size - small->size;
+                if (extra_mines != 0 && extra_mines != extra_cells)
+                    return;
+                for (int i = 0; i < large->size; ++i) {
+                    if (!small->contains(large->cells[i])) {
+                        (extra_mines == 0 ? safe : mines)
+                            .push_back(large->cells[i]);
+                    }
+                }
+            });
+        }
+
+        for (const int safe_cell : safe)
+            set_safe(safe_cell);
+        for (const int mine : mines)
+            set_mine(mine, Knowledge::mine);
+    }
+}
+}
@@ -0,0 +1,117 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include "ThreadPool.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace termmine {
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (unsigned i = 0; i < threads; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+    for (unsigned i = 0; i < threads; ++i)
+        workers_.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{sleep_mutex_};
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+unsigned ThreadPool::size() const noexcept
+{
+    return queues_.size();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    auto& queue = *queues_[next_queue_++ % size()];
+    {
+        std::lock_guard lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock{sleep_mutex_};
+        ++pending_;
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::work(const unsigned id)
+{
+    while (true) {
+        if (run_one(id))
+            continue;
+
+        std::unique_lock lock{sleep_mutex_};
+        wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+        if (stopping_ && pending_ == 0)
+            return;
+    }
+}
+
+bool ThreadPool::run_one(const unsigned id)
+{
+    std::function<void()> task;
+    for (unsigned i = 0; i < size() && !task; ++i) {
+        auto& queue = *queues_[(id + i) % size()];
+        std::lock_guard lock{queue.mutex};
+        if (queue.tasks.empty())
+            continue;
+
+        // Own queue is LIFO for locality, stealing is FIFO
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task)
+        return false;
+
+    {
+        std::lock_guard lock{sleep_mutex_};
+        --pending_;
+    }
+    task();
+    return true;
+}
+}
@@ -27,10 +27,10 @@
 #include <chrono>
 
 namespace termmine {
-void Timer::start() noexcept
+void Timer::start(const std::chrono::milliseconds elapsed) noexcept
 {
     started_= true;
-    start_ = clock_type::now();
+    start_ = clock_type::now() - elapsed;
 }
 
 std::chrono::milliseconds::rep Timer::elapsed() const noexcept
@@ -42,4 +42,9 @@ std::chrono::milliseconds::rep Timer::elapsed() const noexcept
     }
     return 0;
 }
+
+bool Timer::started() const noexcept
+{
+    return started_;
+}
 }
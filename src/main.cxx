@@ -22,12 +22,81 @@
 * SOFTWARE.
 */
 
+#include <clocale>
+#include <cstdio>
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+
 #include <ncurses.h>
 
+#include "Instrument.hxx"
+#include "Options.hxx"
+#include "Replay.hxx"
 #include "play.hxx"
 
-int main()
+#ifdef TERMMINE_INSTRUMENT
+namespace {
+// Appends a stats line to path once a second until stopped
+void write_stats(const std::stop_token stop, const std::string path)
+{
+    std::FILE* const out = std::fopen(path.c_str(), "a");
+    if (!out)
+        return;
+
+    std::mutex mutex;
+    std::condition_variable_any tick;
+    std::unique_lock lock{mutex};
+    while (!tick.wait_for(lock, stop, std::chrono::seconds{1},
+                          [] { return false; })
+           && !stop.stop_requested()) {
+        std::fprintf(out, "%s\n",
+                     termmine::instrument::stats_line().c_str());
+        std::fflush(out);
+    }
+    std::fprintf(out, "%s\n", termmine::instrument::stats_line().c_str());
+    std::fclose(out);
+}
+}
+#endif
+
+int main(int argc, char* argv[])
 {
+    termmine::Options options;
+    try {
+        options = termmine::parse_options(argc, argv);
+    } catch (const std::invalid_argument& err) {
+        std::cerr << "termmine: " << err.what() << '\n' << termmine::usage;
+        return 1;
+    }
+
+    if (!options.record_dir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(options.record_dir, ec);
+        if (ec) {
+            std::cerr << "termmine: cannot create " << options.record_dir
+                << ": " << ec.message() << '\n';
+            return 1;
+        }
+    }
+
+    if (options.unicode)
+        std::setlocale(LC_ALL, "");
+#ifdef TERMMINE_INSTRUMENT
+    if (!options.trace_file.empty())
+        termmine::instrument::start_trace();
+    std::jthread stats;
+    if (!options.stats_file.empty())
+        stats = std::jthread{write_stats, options.stats_file};
+#endif
     initscr();
     noecho();
     raw();
@@ -35,8 +104,29 @@ int main()
     curs_set(0); // hide cursor and manually draw one later
     start_color();
     termmine::define_colors();
-    termmine::main_menu();
+    termmine::define_glyphs(options.unicode);
+    try {
+        if (options.replay_file.empty())
+            termmine::main_menu(options);
+        else
+            termmine::play_replay(options, options.replay_file);
+    } catch (const std::exception& err) {
+        // Bad replays, and I/O or thread errors from the menu
+        endwin();
+        std::cerr << "termmine: " << err.what() << '\n';
+        return 1;
+    }
     endwin();
 
+#ifdef TERMMINE_INSTRUMENT
+    if (!options.trace_file.empty()) {
+        if (std::FILE* const out = std::fopen(options.trace_file.c_str(),
+                                              "w")) {
+            termmine::instrument::write_trace(out);
+            std::fclose(out);
+        }
+    }
+#endif
+
     return 0;
 }
@@ -26,17 +26,37 @@
 
 #include <cinttypes>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <ncurses.h>
 
+#include "Autosave.hxx"
+#include "BoardPreloader.hxx"
+#include "DebugOverlay.hxx"
+#include "FrameScheduler.hxx"
 #include "Game.hxx"
+#include "Generator.hxx"
+#include "HintEngine.hxx"
+#include "Instrument.hxx"
+#include "LatencyTracker.hxx"
+#include "ProbabilityWorker.hxx"
+#include "Options.hxx"
+#include "Replay.hxx"
+#include "ReplayPlayer.hxx"
+#include "ScoreStore.hxx"
 
 namespace termmine {
 namespace {
@@ -54,9 +74,91 @@ enum Color {
     color_five,
     color_six,
     color_seven,
-    color_eight
+    color_eight,
+
+    // Heatmap tints of unopened cells by mine probability
+    color_heat_safe,
+    color_heat_low,
+    color_heat_medium,
+    color_heat_high,
+    color_heat_mine,
+
+    color_hint_safe,
+    color_hint_guess
+};
+
+// Every distinct way a cell can be drawn
+enum Look {
+    // Opened cells are looked up by their number of adjacent mines
+    look_exploded = 9,
+    look_mine,
+    look_flag,
+    look_flag_wrong,
+    look_mark,
+    look_unopened,
+    look_heat_safe,
+    look_heat_low,
+    look_heat_medium,
+    look_heat_high,
+    look_heat_mine,
+    look_hint_safe,
+    look_hint_guess,
+    num_looks
+};
+
+/*
+* Each look is built into a character with its color once at startup, so that
+* drawing a cell is a table lookup in both the ASCII and wide character modes.
+* The second table of each pair is for the cell under the cursor.
+*/
+struct Glyphs {
+    bool wide = false;
+    std::array<std::array<chtype, num_looks>, 2> looks{};
+    std::array<std::array<cchar_t, num_looks>, 2> wide_looks{};
 };
 
+Glyphs glyphs;
+
+int cell_look(const Game& game, const int row, const int col) noexcept
+{
+    if (game.is_open(row, col))
+        return game.has_mine(row, col) ? look_exploded
+            : game.num_adj_mines(row, col);
+    if (game.is_over() && !game.has_won() && game.has_mine(row, col))
+        return look_mine;
+    if (game.has_flag(row, col)) {
+        return game.is_over() && !game.has_mine(row, col) ? look_flag_wrong
+            : look_flag;
+    }
+    if (game.has_mark(row, col))
+        return look_mark;
+    return look_unopened;
+}
+
+// Heatmap look of an unopened cell with the given chance of being a mine
+int heat_look(const double prob) noexcept
+{
+    if (prob < 1e-9)
+        return look_heat_safe;
+    if (prob > 1 - 1e-9)
+        return look_heat_mine;
+    if (prob < 0.2)
+        return look_heat_low;
+    if (prob < 0.5)
+        return look_heat_medium;
+    return look_heat_high;
+}
+
+void draw_look(WINDOW* const board, const int row, const int col,
+               const int look, const bool cursor) noexcept
+{
+    wmove(board, row * 2 + 1, col * 2 + 1);
+    if (glyphs.wide)
+        wadd_wch(board, &glyphs.wide_looks[cursor][look]);
+    else
+        waddch(board, glyphs.looks[cursor][look]);
+}
+
 /*
 * Encode grid position to simplify draw_board() conditionals.
 * Determines if pos is on the board edge, intersection, or other gridline.
@@ -136,6 +238,15 @@ void define_colors() noexcept
     init_pair(color_seven, COLOR_WHITE, COLOR_BLACK);
     init_pair(color_eight, COLOR_WHITE, COLOR_BLACK);
 
+    init_pair(color_heat_safe, COLOR_BLACK, COLOR_GREEN);
+    init_pair(color_heat_low, COLOR_BLACK, COLOR_CYAN);
+    init_pair(color_heat_medium, COLOR_BLACK, COLOR_YELLOW);
+    init_pair(color_heat_high, COLOR_BLACK, COLOR_MAGENTA);
+    init_pair(color_heat_mine, COLOR_BLACK, COLOR_RED);
+
+    init_pair(color_hint_safe, COLOR_WHITE, COLOR_GREEN);
+    init_pair(color_hint_guess, COLOR_WHITE, COLOR_MAGENTA);
+
     init_pair(color_unopened + 20, COLOR_BLACK, COLOR_YELLOW);
     init_pair(color_flagged + 20, COLOR_RED, COLOR_YELLOW);
     init_pair(color_opened + 20, COLOR_WHITE, COLOR_YELLOW);
@@ -150,10 +261,70 @@ void define_colors() noexcept
     init_pair(color_eight + 20, COLOR_WHITE, COLOR_YELLOW);
 }
 
+void define_glyphs(const bool wide) noexcept
+{
+    constexpr std::array<std::pair<int, short>, num_looks> looks{{
+        {' ', color_opened},
+        {'1', color_one},
+        {'2', color_two},
+        {'3', color_three},
+        {'4', color_four},
+        {'5', color_five},
+        {'6', color_six},
+        {'7', color_seven},
+        {'8', color_eight},
+        {'@', color_mine},
+        {'@', color_opened},
+        {'P', color_flagged},
+        {'X', color_mine_wrong},
+        {'?', color_unopened},
+        {' ', color_unopened},
+        {' ', color_heat_safe},
+        {' ', color_heat_low},
+        {' ', color_heat_medium},
+        {' ', color_heat_high},
+        {' ', color_heat_mine},
+        {'*', color_hint_safe},
+        {'*', color_hint_guess}
+    }};
+    constexpr std::array<wchar_t, num_looks> wide_chars{
+        L' ', L'1', L'2', L'3', L'4', L'5', L'6', L'7', L'8',
+        L'\u2739', // exploded mine
+        L'\u2739', // mine
+        L'\u2691', // flag
+        L'\u2717', // wrong flag
+        L'?',
+        L' ',
+        L' ', L' ', L' ', L' ', L' ',
+        L'*', L'*'
+    };
+
+    glyphs.wide = wide;
+    for (int cursor = 0; cursor < 2; ++cursor) {
+        for (int i = 0; i < num_looks; ++i) {
+            const short color = looks[i].second + cursor * 20;
+            glyphs.looks[cursor][i] = looks[i].first | COLOR_PAIR(color);
+            const wchar_t wch[]{wide_chars[i], L'\0'};
+            setcchar(&glyphs.wide_looks[cursor][i], wch, A_NORMAL, color,
+                     nullptr);
+        }
+    }
+}
+
+void draw_header() noexcept
+{
+    mvprintw(0, 0, "Mines remaining:");
+    mvprintw(1, 0, "Time:");
+}
+
 void update_time(const Game& game) noexcept
+{
+    update_time(game.get_time());
+}
+
+void update_time(const std::chrono::milliseconds::rep time) noexcept
 {
     std::ostringstream oss;
-    auto time = game.get_time();
     oss.fill('0');
     if (time >= 60000)
         oss << time / 60000 << ':' << std::setw(2);
@@ -163,84 +334,113 @@ void update_time(const Game& game) noexcept
     printw("%s", oss.str().c_str());
 }
 
-void draw_board(WINDOW* const board, const Game& game) noexcept
+BoardCache make_board_cache(const Game& game)
 {
-    for (int i = 0; i < game.rows() * 2 + 1; ++i) {
-        for (int j = 0; j < game.cols() * 2 + 1; ++j) {
+    BoardCache cache;
+    const int width = game.cols() * 2 + 1;
+    for (unsigned char i = 0; i < cache.grid_rows.size(); ++i) {
+        auto& row = cache.grid_rows[i];
+        row.reserve(width);
+        for (int j = 0; j < width; ++j) {
             // Encode each position into 4 bits to simplify check
-            const unsigned char encoded = (encode_grid_pos(i, game.rows()) << 2)
+            const unsigned char encoded = (i << 2)
                 | encode_grid_pos(j, game.cols());
-
-            mvwaddch(board, i, j, decode_grid_symbol(encoded));
+            row.push_back(decode_grid_symbol(encoded));
         }
     }
+    cache.cells.assign(game.rows() * game.cols(), BoardCache::stale);
+    return cache;
+}
+
+void invalidate_cells(BoardCache& cache, const Game& game, const int top,
+                      const int left, const int bottom, const int right)
+    noexcept
+{
+    // Cell (i, j) is drawn at (i * 2 + 1, j * 2 + 1)
+    for (int i = top / 2; i < std::min(bottom / 2, game.rows()); ++i) {
+        for (int j = left / 2; j < std::min(right / 2, game.cols()); ++j)
+            cache.cells[i * game.cols() + j] = BoardCache::stale;
+    }
 }
 
-void update_board(WINDOW* const board, const Game& game) noexcept
+void draw_board(WINDOW* const board, const Game& game,
+                const BoardCache& cache) noexcept
+{
+    draw_board(board, game, cache, 0, 0, game.rows() * 2 + 1,
+               game.cols() * 2 + 1);
+}
+
+void draw_board(WINDOW* const board, const Game& game,
+                const BoardCache& cache, const int top, const int left,
+                const int bottom, const int right) noexcept
+{
+    for (int i = top; i < bottom; ++i) {
+        const auto& row = cache.grid_rows[encode_grid_pos(i, game.rows())];
+        mvwaddchnstr(board, i, left, row.data() + left, right - left);
+    }
+}
+
+void update_board(WINDOW* const board, const Game& game, BoardCache& cache,
+                  const std::vector<double>& heat,
+                  const std::optional<Hint>& hint) noexcept
 {
     move(0, 17);
     clrtoeol();
     printw("%d", game.mines() - game.flags());
+    const unsigned over = game.is_over() << 8 | game.has_won() << 9;
     for (int i = 0; i < game.rows(); ++i) {
         for (int j = 0; j < game.cols(); ++j) {
-            if (game.is_open(i, j)) {
-                wmove(board, i * 2 + 1, j * 2 + 1);
-                if (game.has_mine(i, j)) {
-                    wattron(board, COLOR_PAIR(color_mine));
-                    waddch(board, '@');
-                    wattroff(board, COLOR_PAIR(color_mine));
-                } else {
-                    const int adj_mines = game.num_adj_mines(i, j);
-                    chtype color = COLOR_PAIR(adj_mines > 0
-                        ? adj_mines + color_one - 1 : color_opened);
-
-                    wattron(board, color);
-                    waddch(board, adj_mines > 0 ? '0' + adj_mines : ' ');
-                    wattroff(board, color);
-                }
-            } else if (game.is_over() && !game.has_won()
-                && game.has_mine(i, j)) {
-                wattron(board, COLOR_PAIR(color_opened));
-                mvwaddch(board, i * 2 + 1, j * 2 + 1, '@');
-                wattroff(board, COLOR_PAIR(color_opened));
-            } else if (game.has_flag(i, j)) {
-                if (game.is_over() && !game.has_mine(i, j)) {
-                    wattron(board, COLOR_PAIR(color_mine_wrong));
-                    mvwaddch(board, i * 2 + 1, j * 2 + 1, 'X');
-                    wattroff(board, COLOR_PAIR(color_mine_wrong));
-                } else {
-                    wattron(board, COLOR_PAIR(color_flagged));
-                    mvwaddch(board, i * 2 + 1, j * 2 + 1, 'P');
-                    wattroff(board, COLOR_PAIR(color_flagged));
-                }
-            } else if (game.has_mark(i, j)) {
-                wattron(board, COLOR_PAIR(color_unopened));
-                mvwaddch(board, i * 2 + 1, j * 2 + 1, '?');
-                wattroff(board, COLOR_PAIR(color_unopened));
-            } else {
-                wattron(board, COLOR_PAIR(color_unopened));
-                mvwaddch(board, i * 2 + 1, j * 2 + 1, ' ');
-                wattroff(board, COLOR_PAIR(color_unopened));
-            }
+            // A cell's look only depends on its byte, the game's outcome, its
+            // heatmap tint and whether it is hinted
+            int look = cell_look(game, i, j);
+            if (look == look_unopened && !heat.empty())
+                look = heat_look(heat[i * game.cols() + j]);
+            if (hint && hint->row == i && hint->col == j && !game.is_open(i, j))
+                look = hint->safe ? look_hint_safe : look_hint_guess;
+
+            auto& drawn = cache.cells[i * game.cols() + j];
+            const unsigned state = game.board()[i][j] | over | look << 10;
+            if (drawn == state)
+                continue;
+            drawn = state;
+
+            draw_look(board, i, j, look, false);
+            TERMMINE_COUNT(cells_redrawn, 1);
         }
     }
+}
 
-#ifdef NDEBUG
-    for (int i = 0; const auto& row : game.board()) {
-        move(i + 5, game.cols() * 2 + 3);
-        for (const auto col : row)
-            printw("%02x ", col);
-        addch('\n');
-        ++i;
-    }
-#endif
+void draw_cursor(WINDOW* const board, const Game& game,
+                 const Cursor cursor) noexcept
+{
+    draw_look(board, cursor.y, cursor.x, cell_look(game, cursor.y, cursor.x),
+              true);
 }
 
-void draw_cursor(WINDOW* const board, const Cursor cursor) noexcept
+void relayout(WINDOW* const board, const Game& game, BoardCache& cache)
+    noexcept
 {
-    wmove(board, cursor.y * 2 + 1, cursor.x * 2 + 1);
-    const chtype attrs = winch(board);
-    wchgat(board, 1, attrs, PAIR_NUMBER(attrs & A_COLOR) + 20, nullptr);
+    // What the terminal shows after a resize can't be trusted, but the
+    // windows' contents can, so they only need to be copied out again
+    clearok(curscr, true);
+    touchwin(stdscr);
+    touchwin(board);
+    draw_header();
+
+    // Shrinking the terminal truncates the board window and loses whatever
+    // was cut off, so grow it back and only repaint the lost region
+    const int height = game.rows() * 2 + 1;
+    const int width = game.cols() * 2 + 1;
+    const int kept_height = std::min(getmaxy(board), height);
+    const int kept_width = std::min(getmaxx(board), width);
+    if (kept_height == height && kept_width == width)
+        return;
+
+    wresize(board, height, width);
+    draw_board(board, game, cache, kept_height, 0, height, width);
+    draw_board(board, game, cache, 0, kept_width, kept_height, width);
+    invalidate_cells(cache, game, kept_height, 0, height, width);
+    invalidate_cells(cache, game, 0, kept_width, kept_height, width);
 }
 
 void show_seed(const Game& game) noexcept
@@ -248,37 +448,182 @@ void show_seed(const Game& game) noexcept
     mvprintw(3, game.cols() * 2 + 3, "Seed: %" PRIuFAST64 "\n", game.seed());
 }
 
-void new_game(const int rows, const int cols, const int mines,
-              const std::optional<std::uint_fast64_t> seed)
+void show_latency(const LatencyTracker& latency) noexcept
+{
+    printw("Input to display: p50 %.1f ms, p99 %.1f ms over %zu keys\n",
+           latency.percentile(50) / 1000.0, latency.percentile(99) / 1000.0,
+           latency.samples());
+}
+
+// Time is when the last move was made, as recorded for the game
+void show_score(const Game& game, const std::int64_t time) noexcept
+{
+    const double seconds = time / 1000.0;
+    printw("3BV: %d of %d, %.2f 3BV/s, %d clicks, %.0f%% efficiency\n",
+           game.solved_bbbv(), game.bbbv(),
+           seconds > 0 ? game.solved_bbbv() / seconds : 0.0, game.clicks(),
+           game.clicks() > 0 ? 100.0 * game.solved_bbbv() / game.clicks()
+           : 0.0);
+}
+
+void show_best(const ScoreStore& scores, const Game& game, const bool no_guess,
+               const bool new_best) noexcept
+{
+    const BoardScores* const board = scores.scores(game.rows(), game.cols(),
+                                                   game.mines(), no_guess);
+    if (new_best)
+        printw("New best time! ");
+    if (board && board->best)
+        printw("Best %.3f s, ", board->best->time / 1000.0);
+    if (board)
+        printw("won %d of %d games\n", board->wins, board->games);
+}
+
+void new_game(const Options& options, BoardPreloader& boards,
+              ScoreStore& scores)
 {
+    clear();
+    if (!boards.ready()) {
+        printw("Generating board...");
+        refresh();
+    }
+    auto deal = boards.take();
+    if (options.no_guess && !deal.no_guess) {
+        // The board isn't scored as no-guess, so the player should know
+        clear();
+        printw("No board solvable without guessing was found, so this one "
+               "may need a guess.\nPress any key to play it.");
+        refresh();
+        nodelay(stdscr, false);
+        getch();
+    }
+    play_game(options, std::move(deal.game), deal.no_guess, {}, scores);
+}
+
+void play_game(const Options& options, Game game, const bool no_guess,
+               const std::vector<ReplayEvent>& history, ScoreStore& scores)
+{
+    std::optional<ReplayWriter> replay;
+    if (!options.record_dir.empty()) {
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        const auto path = std::filesystem::path{options.record_dir}
+            / (std::to_string(game.seed()) + '-' + std::to_string(now)
+               + ".tmr");
+        replay.emplace(path.string(), game);
+        if (!replay->good()) {
+            // Playing on without a recording is better than losing the game
+            replay.reset();
+            clear();
+            printw("Cannot write a replay to %s, so this game won't be "
+                   "recorded.\nPress any key to play it.",
+                   options.record_dir.c_str());
+            refresh();
+            nodelay(stdscr, false);
+            getch();
+        } else {
+            for (const auto& move : history)
+                replay->record(move.action, move.row, move.col, move.time);
+        }
+    }
+    std::optional<Autosave> autosave;
+    if (!options.scores_dir.empty())
+        autosave.emplace(options.scores_dir, game, history);
+    // The timer keeps running after the game ends, so the final time is taken
+    // at the last move
+    std::int64_t move_time = history.empty() ? 0 : history.back().time;
+    auto act = [&](const Action action, const Cursor at) {
+        apply_action(game, action, at.y, at.x);
+        move_time = game.get_time();
+        if (replay)
+            replay->record(action, at.y, at.x, move_time);
+        if (autosave)
+            autosave->record(action, at.y, at.x, move_time);
+    };
+
     clear();
     define_colors();
     refresh();
-    printw("Mines remaining:\n");
-    printw("Time:\n");
+    draw_header();
 
-    Game game{seed ? Game{rows, cols, mines, *seed} : Game{rows, cols, mines}};
     WINDOW *const board = newwin(game.rows() * 2 + 1, game.cols() * 2 + 1,
                                  3, 0);
 
 #ifdef NDEBUG
-    show_seed(game);
-    refresh();
+    DebugOverlay overlay{game, 3, game.cols() * 2 + 3, false};
+#else
+    DebugOverlay overlay{game, 3, game.cols() * 2 + 3, true};
 #endif
 
-    draw_board(board, game);
+    BoardCache cache{make_board_cache(game)};
+    draw_board(board, game, cache);
     wrefresh(board);
 
-    Cursor cursor{0, 0};
+    const std::vector<double> no_heat;
+    FrameScheduler frames{options.frame_rate};
+    LatencyTracker latency;
+    // Shared by the heatmap and hints, started the first time either is used
+    std::optional<ProbabilityWorker> probabilities;
+    bool show_heatmap = false;
+    HintEngine hints{game, options.hint_budget};
+    // No-guess boards are only guaranteed solvable from their start cell
+    const auto [start_row, start_col] = no_guess
+        ? NoGuessGenerator::start_cell(game.rows(), game.cols())
+        : std::pair{0, 0};
+    Cursor cursor{start_col, start_row};
+    Cursor drawn_cursor{cursor};
     wattron(board, A_BOLD);
     while (!game.is_over()) {
-        update_time(game);
-        refresh();
-        update_board(board, game);
-        draw_cursor(board, cursor);
-        wrefresh(board);
+        if (show_heatmap) {
+            probabilities->request(game);
+            if (probabilities->poll())
+                frames.invalidate();
+        }
+        if (hints.refining() && hints.refine(*probabilities))
+            frames.invalidate();
+
+        // The clock only needs frames of its own once it is running
+        frames.set_animating(game.timer_started());
+        if (frames.frame_due()) {
+            // The clock is drawn every frame, the board only when it changed
+            const bool dirty = frames.dirty();
+            frames.frame_begin();
+            update_time(game);
+            overlay.update(game, frames);
+            if (dirty) {
+                // Clear the old cursor highlight along with any other changes
+                invalidate_cells(cache, game, drawn_cursor.y * 2 + 1,
+                                 drawn_cursor.x * 2 + 1, drawn_cursor.y * 2 + 2,
+                                 drawn_cursor.x * 2 + 2);
+                // A result for an older board is never shown
+                const bool heat = show_heatmap && probabilities->fresh(game);
+                update_board(board, game, cache,
+                             heat ? probabilities->result().probs : no_heat,
+                             hints.current());
+                draw_cursor(board, game, cursor);
+                drawn_cursor = cursor;
+            }
+            wnoutrefresh(stdscr);
+            if (dirty)
+                wnoutrefresh(board);
+            doupdate();
+            frames.frame_end();
+            if (options.latency)
+                latency.frame_shown();
+        }
 
+        // Check back soon for probabilities still being computed
+        const bool waiting = (show_heatmap || hints.refining())
+            && probabilities->busy();
+        const int wait = frames.wait_ms();
+        timeout(waiting && (wait < 0 || wait > 10) ? 10 : wait);
         int c = getch();
+        if (c == ERR)
+            continue;
+        overlay.count_key();
+        frames.invalidate();
+        if (options.latency)
+            latency.key_pressed();
         switch (c) {
         case KEY_LEFT:
             if (cursor.x > 0)
@@ -298,44 +643,257 @@ void new_game(const int rows, const int cols, const int mines,
             break;
 
         case ' ':
-            if (game.is_open(cursor.y, cursor.x))
-                game.chord_cell(cursor.y, cursor.x);
-            else
-                game.open_cell(cursor.y, cursor.x);
-            game.check_win(cursor.y, cursor.x);
+            act(game.is_open(cursor.y, cursor.x) ? Action::chord
+                : Action::open, cursor);
             break;
         case '1':
-            game.flag_cell(cursor.y, cursor.x);
+            act(Action::flag, cursor);
             break;
         case '2':
-            game.mark_cell(cursor.y, cursor.x);
+            act(Action::mark, cursor);
+            break;
+        case 'h':
+            if (!probabilities)
+                probabilities.emplace();
+            hints.request(*probabilities);
+            break;
+        case 'p':
+            if (!probabilities)
+                probabilities.emplace();
+            show_heatmap = !show_heatmap;
+            break;
+        case ctrl('d'):
+            overlay.toggle();
+            break;
+        case KEY_RESIZE:
+            relayout(board, game, cache);
+            overlay.invalidate();
             break;
 
         case ctrl('q'):
+            if (replay)
+                replay->finish(false, game.get_time());
+            if (autosave)
+                autosave->discard();
             show_seed(game);
-            refresh();
             move(game.rows() * 2 + 4, 0);
+            if (options.latency) {
+                latency.discard();
+                show_latency(latency);
+            }
+            refresh();
             return;
         }
     }
 
-    update_board(board, game);
+    // The game ended with the last move
+    if (replay)
+        replay->finish(game.has_won(), move_time);
+    if (autosave)
+        autosave->discard();
+    const bool new_best = scores.add(GameRecord{
+        game.rows(), game.cols(), game.mines(), no_guess, game.seed(),
+        move_time, game.bbbv(), game.has_won()});
+    update_board(board, game, cache, no_heat, std::nullopt);
     wrefresh(board);
+    if (options.latency)
+        latency.frame_shown();
+    update_time(move_time);
     show_seed(game);
     move(game.rows() * 2 + 4, 0);
     if (game.has_won())
         printw("You swept through the minefield safely. You won!\n");
     else
         printw("You exploded. Game over.\n");
+    show_score(game, move_time);
+    show_best(scores, game, no_guess, new_best);
+    if (options.latency)
+        show_latency(latency);
     refresh();
 }
 
-void game_menu(const int rows, const int cols, const int mines,
-               const std::optional<std::uint_fast64_t> seed)
+void play_replay(const Options& options, const std::string& path)
 {
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+        throw BadReplay{"Cannot open replay file"};
+    const std::vector<unsigned char> data{std::istreambuf_iterator<char>{file},
+                                          {}};
+    ReplayPlayer player{ReplayReader{data.data(), data.size()}};
+
+    clear();
+    refresh();
+    draw_header();
+    WINDOW *const board = newwin(player.header().rows * 2 + 1,
+                                 player.header().cols * 2 + 1, 3, 0);
+    BoardCache cache{make_board_cache(player.game())};
+    draw_board(board, player.game(), cache);
+    wrefresh(board);
+
+    // Multiples of real time, with 0 for as fast as possible
+    constexpr std::array speeds{1, 2, 5, 10, 20, 50, 100, 0};
+    std::size_t speed = 0;
+    bool paused = false;
+
+    // The replay's clock runs at the chosen speed from where it was last set
+    using clock_type = std::chrono::steady_clock;
+    auto clock_start = clock_type::now();
+    std::int64_t clock_base = 0;
+    auto replay_time = [&] {
+        if (paused || speeds[speed] == 0)
+            return clock_base;
+        return clock_base + speeds[speed]
+            * std::chrono::duration_cast<std::chrono::milliseconds>(
+                clock_type::now() - clock_start).count();
+    };
+    auto set_clock = [&](const std::int64_t time) {
+        clock_base = time;
+        clock_start = clock_type::now();
+    };
+
+    const std::vector<double> no_heat;
+    FrameScheduler frames{options.frame_rate};
+    std::optional<Cursor> drawn_cursor;
+    wattron(board, A_BOLD);
     while (true) {
-        nodelay(stdscr, true);
-        new_game(rows, cols, mines, seed);
+        // Apply the moves that are due, or one move per pass at full speed
+        if (!paused && speeds[speed] == 0) {
+            if (player.step()) {
+                set_clock(player.time());
+                frames.invalidate();
+            }
+        } else if (!paused) {
+            const std::int64_t now = replay_time();
+            while (player.position() < player.size()
+                   && player.next_time() <= now) {
+                player.step();
+                frames.invalidate();
+            }
+        }
+        const bool finished = player.position() == player.size();
+        frames.set_animating(!paused && !finished);
+
+        if (frames.frame_due()) {
+            const bool dirty = frames.dirty();
+            frames.frame_begin();
+            update_time(finished ? player.duration()
+                        : std::clamp(replay_time(), player.time(),
+                                     player.next_time()));
+            move(2, 0);
+            clrtoeol();
+            if (speeds[speed] == 0)
+                printw("Replay at max speed");
+            else
+                printw("Replay at %dx", speeds[speed]);
+            printw(", move %zu of %zu", player.position(), player.size());
+            if (finished && player.end())
+                printw(", %s", player.end()->won ? "won" : "lost");
+            else if (paused)
+                printw(", paused");
+
+            if (dirty) {
+                const Game& game = player.game();
+                if (drawn_cursor) {
+                    invalidate_cells(cache, game, drawn_cursor->y * 2 + 1,
+                                     drawn_cursor->x * 2 + 1,
+                                     drawn_cursor->y * 2 + 2,
+                                     drawn_cursor->x * 2 + 2);
+                }
+                update_board(board, game, cache, no_heat, std::nullopt);
+                // The cursor follows the moves
+                drawn_cursor.reset();
+                if (const ReplayEvent* const last = player.last()) {
+                    drawn_cursor = Cursor{last->col, last->row};
+                    draw_cursor(board, game, *drawn_cursor);
+                }
+            }
+            wnoutrefresh(stdscr);
+            if (dirty)
+                wnoutrefresh(board);
+            doupdate();
+            frames.frame_end();
+        }
+
+        // Sleep until the next move is due, unless there's input first
+        int wait = frames.wait_ms();
+        if (!paused && !finished) {
+            const int until_move = speeds[speed] == 0 ? 0
+                : static_cast<int>((player.next_time() - replay_time())
+                                   / speeds[speed]);
+            wait = std::min(wait, until_move);
+        }
+        timeout(wait);
+        int c = getch();
+        if (c == ERR)
+            continue;
+        frames.invalidate();
+        switch (c) {
+        case ' ':
+            if (!paused)
+                set_clock(replay_time());
+            paused = !paused;
+            set_clock(clock_base);
+            break;
+        case KEY_UP:
+            set_clock(replay_time());
+            speed = std::min(speed + 1, speeds.size() - 1);
+            break;
+        case KEY_DOWN:
+            set_clock(replay_time());
+            speed = speed > 0 ? speed - 1 : 0;
+            break;
+        case KEY_LEFT:
+        case KEY_RIGHT: {
+            constexpr std::int64_t step = 5000;
+            const std::int64_t time = std::clamp<std::int64_t>(
+                replay_time() + (c == KEY_LEFT ? -step : step), 0,
+                player.duration());
+            player.seek_time(time);
+            set_clock(time);
+            break;
+        }
+        case KEY_HOME:
+            player.seek(0);
+            set_clock(0);
+            break;
+        case KEY_END:
+            player.seek(player.size());
+            set_clock(player.duration());
+            break;
+        case KEY_RESIZE:
+            relayout(board, player.game(), cache);
+            break;
+
+        case ctrl('q'):
+            return;
+        }
+    }
+}
+
+void game_menu(const Options& options, ScoreStore& scores, const int rows,
+               const int cols, const int mines,
+               const std::optional<std::uint_fast64_t> seed,
+               std::optional<SavedGame> resume)
+{
+    // The next board is built while this one is played
+    BoardPreloader boards{rows, cols, mines, seed, options.no_guess};
+    while (true) {
+        if (resume) {
+            // The autosave doesn't say how the board was found, so it is
+            // checked again
+            const auto& header = resume->header;
+            const auto [row, col] = NoGuessGenerator::start_cell(header.rows,
+                                                                 header.cols);
+            const bool no_guess = options.no_guess
+                && solvable_without_guessing(
+                    Game{header.rows, header.cols, header.mines, header.seed},
+                    row, col);
+            play_game(options, resume->restore(), no_guess, resume->moves,
+                      scores);
+            resume.reset();
+        } else {
+            new_game(options, boards, scores);
+        }
         nodelay(stdscr, false);
 
         clrtoeol();
@@ -356,7 +914,7 @@ void game_menu(const int rows, const int cols, const int mines,
     }
 }
 
-void create_custom_board()
+void create_custom_board(const Options& options, ScoreStore& scores)
 {
     const std::array<const std::string, 4> prompts{
         "Number of rows: ",
@@ -404,7 +962,7 @@ void create_custom_board()
     if (mines >= *rows * *cols)
         mines = *rows * *cols - 1;
 
-    game_menu(*rows, *cols, *mines, seed);
+    game_menu(options, scores, *rows, *cols, *mines, seed);
 }
 
 void main_menu_select(int& option, const int num_options) noexcept
@@ -434,15 +992,42 @@ void main_menu_select(int& option, const int num_options) noexcept
     }
 }
 
-void main_menu() noexcept
+bool ask_resume(const SavedGame& saved)
 {
-    constexpr std::array options{
+    // A game saved just as it ended can't go on
+    if (saved.restore().is_over())
+        return false;
+
+    printw("\nResume the unfinished %d x %d game with %d mines after %zu "
+           "moves? (y/n)", saved.header.rows, saved.header.cols,
+           saved.header.mines, saved.moves.size());
+    while (true) {
+        switch (getch()) {
+        case 'y':
+            return true;
+        case 'n':
+            return false;
+        }
+    }
+}
+
+void main_menu(const Options& options)
+{
+    constexpr std::array menu_options{
         "Beginner\t9 x 9\t\t10 mines",
         "Intermediate\t16 x 16\t\t40 mines",
         "Advanced\t16 x 30\t\t99 mines",
         "Custom board",
         "Quit"
     };
+    // Rows, cols and mines of the first three options
+    constexpr std::array<std::array<int, 3>, 3> presets{{
+        {9, 9, 10},
+        {16, 16, 40},
+        {16, 30, 99}
+    }};
+    ScoreStore scores{options.scores_dir};
+    bool offered_resume = false;
 
     int option = 0; // remember chosen option after game ends
     bool quit = false;
@@ -462,27 +1047,45 @@ void main_menu() noexcept
         printw(" @\n\n");
         attroff(A_BOLD);
 
-        for (const auto opt : options) {
-            printw(opt);
+        for (std::size_t i = 0; i < menu_options.size(); ++i) {
+            printw(menu_options[i]);
+            if (i < presets.size()) {
+                const BoardScores* const board = scores.scores(
+                    presets[i][0], presets[i][1], presets[i][2],
+                    options.no_guess);
+                if (board && board->best)
+                    printw("\tBest %.3f s", board->best->time / 1000.0);
+            }
             addch('\n');
         }
 
-        // Option select
-        main_menu_select(option, options.size());
         try {
+            // Offer to carry on a game cut short by a crash or a dropped
+            // connection, once
+            if (!offered_resume && !options.scores_dir.empty()) {
+                offered_resume = true;
+                if (auto saved = Autosave::load(options.scores_dir);
+                    saved && ask_resume(*saved)) {
+                    const ReplayHeader header = saved->header;
+                    game_menu(options, scores, header.rows, header.cols,
+                              header.mines, std::nullopt, std::move(saved));
+                    continue;
+                }
+                Autosave::remove(options.scores_dir);
+            }
+
+            // Option select
+            main_menu_select(option, menu_options.size());
             switch (option) {
             case 0:
-                game_menu(9, 9, 10);
-                break;
             case 1:
-                game_menu(16, 16, 40);
-                break;
             case 2:
-                game_menu(16, 30, 99);
+                game_menu(options, scores, presets[option][0],
+                          presets[option][1], presets[option][2]);
                 break;
             case 3:
-                move(options.size() + 3, 0);
-                create_custom_board();
+                move(menu_options.size() + 3, 0);
+                create_custom_board(options, scores);
                 break;
             default:
                 return;
@@ -28,13 +28,21 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <array>
+#include <chrono>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <ncurses.h>
 
+#include "Autosave.hxx"
+#include "BoardPreloader.hxx"
 #include "Game.hxx"
+#include "HintEngine.hxx"
+#include "Options.hxx"
+#include "ScoreStore.hxx"
 
 namespace termmine {
 struct Cursor {
@@ -42,29 +50,74 @@ struct Cursor {
     int y;
 };
 
+// What the board window currently shows, so that only changes are redrawn
+struct BoardCache {
+    static constexpr unsigned stale = ~0u;
+
+    // Every gridline row has one of four shapes, indexed by encode_grid_pos()
+    std::array<std::vector<chtype>, 4> grid_rows;
+    // Drawn state of each cell in row-major order, or stale if unknown
+    std::vector<unsigned> cells;
+};
+
 constexpr int ctrl(int c) noexcept;
 
 void define_colors() noexcept;
+// Builds the table of cell glyphs, using Unicode symbols if wide is set
+void define_glyphs(bool wide) noexcept;
 
+void draw_header() noexcept;
 void update_time(const Game& game) noexcept;
-void draw_board(WINDOW* board, const Game& game) noexcept;
-void update_board(WINDOW* board, const Game& game) noexcept;
-void draw_cursor(WINDOW* board, Cursor cursor) noexcept;
-
-void new_game(int rows, int cols, int mines,
-              std::optional<std::uint_fast64_t> seed);
-
-// Handles leaving or playing again
-void game_menu(int rows, int cols, int mines,
-               std::optional<std::uint_fast64_t> seed = std::nullopt);
+void update_time(std::chrono::milliseconds::rep time) noexcept;
+
+BoardCache make_board_cache(const Game& game);
+// Marks the cells inside a region of the board window for redrawing
+void invalidate_cells(BoardCache& cache, const Game& game, int top, int left,
+                      int bottom, int right) noexcept;
+
+void draw_board(WINDOW* board, const Game& game, const BoardCache& cache)
+    noexcept;
+// Draws the gridlines inside a region of the board window
+void draw_board(WINDOW* board, const Game& game, const BoardCache& cache,
+                int top, int left, int bottom, int right) noexcept;
+// heat is each cell's chance of being a mine to tint unopened cells by, or
+// empty for no tint, and hint is the cell to point the player to, if any
+void update_board(WINDOW* board, const Game& game, BoardCache& cache,
+                  const std::vector<double>& heat,
+                  const std::optional<Hint>& hint) noexcept;
+void draw_cursor(WINDOW* board, const Game& game, Cursor cursor) noexcept;
+
+// Restores the parts of the screen lost after the terminal was resized
+void relayout(WINDOW* board, const Game& game, BoardCache& cache) noexcept;
+
+// Adds the game to scores once it is finished
+void new_game(const Options& options, BoardPreloader& boards,
+              ScoreStore& scores);
+// Plays a game, where history is the moves already made on it, if resumed.
+// no_guess is whether the board is known to be solvable without guessing.
+void play_game(const Options& options, Game game, bool no_guess,
+               const std::vector<ReplayEvent>& history, ScoreStore& scores);
+
+// Plays back a recorded game. Throws BadReplay if it can't be read.
+void play_replay(const Options& options, const std::string& path);
+
+// Handles leaving or playing again, starting with resume if given
+void game_menu(const Options& options, ScoreStore& scores, int rows, int cols,
+               int mines,
+               std::optional<std::uint_fast64_t> seed = std::nullopt,
+               std::optional<SavedGame> resume = std::nullopt);
 
 template <typename T, typename Val>
 std::optional<T> get_valid_num(int prompt_len, Val&& validate) noexcept;
-void create_custom_board();
+void create_custom_board(const Options& options, ScoreStore& scores);
 
+// Asks whether to resume a saved game, if it can be
+bool ask_resume(const SavedGame& saved);
 // Handles selection of main menu options
 void main_menu_select(int& option, int num_options) noexcept;
-void main_menu() noexcept;
+// Throws on errors from the score files, autosave or board threads, which the
+// caller reports once the terminal is restored
+void main_menu(const Options& options);
 
 template <typename T, typename Val>
 std::optional<T> get_valid_num(const int prompt_len, Val&& validate) noexcept
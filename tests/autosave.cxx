@@ -0,0 +1,81 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <filesystem>
+#include <string>
+
+#include "Autosave.hxx"
+#include "Game.hxx"
+#include "Replay.hxx"
+
+namespace {
+using namespace termmine;
+
+bool fail(const char* what)
+{
+    std::fprintf(stderr, "%s\n", what);
+    return false;
+}
+
+// Saves a game on seed 7 with the given moves into dir
+void save(const std::string& dir, const int moves)
+{
+    const Game game{9, 9, 10, 7};
+    Autosave autosave{dir, game};
+    for (int move = 0; move < moves; ++move)
+        autosave.record(Action::flag, 0, move, move);
+}
+}
+
+int main()
+{
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "termmine-test-autosave";
+    const fs::path old_dir = dir / "old";
+    fs::remove_all(dir);
+    bool passed = true;
+
+    // Moves that only reached the journal are loaded
+    save(dir.string(), 3);
+    const auto saved = Autosave::load(dir.string());
+    if (!saved || saved->moves.size() != 3 || saved->moves[2].col != 2)
+        passed = fail("journaled moves not loaded");
+
+    // A crash between writing a new checkpoint and restarting the journal
+    // leaves the last game's journal, on the same seed, next to it
+    fs::create_directories(old_dir);
+    fs::copy_file(dir / "autosave.journal", old_dir / "autosave.journal");
+    save(dir.string(), 0);
+    fs::copy_file(old_dir / "autosave.journal", dir / "autosave.journal",
+                  fs::copy_options::overwrite_existing);
+    const auto fresh = Autosave::load(dir.string());
+    if (!fresh || !fresh->moves.empty())
+        passed = fail("journal from another game applied");
+
+    fs::remove_all(dir);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
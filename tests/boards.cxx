@@ -0,0 +1,149 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "BoardFormat.hxx"
+
+namespace {
+using namespace termmine;
+
+bool fail(const char* format, const char* what)
+{
+    std::fprintf(stderr, "%s: %s\n", format, what);
+    return false;
+}
+
+// The input as a file to read from
+std::FILE* file_of(const std::string& data)
+{
+    std::FILE* const file = std::tmpfile();
+    std::fwrite(data.data(), 1, data.size(), file);
+    std::rewind(file);
+    return file;
+}
+
+bool same(Board a, Board b)
+{
+    std::sort(a.mines.begin(), a.mines.end());
+    std::sort(b.mines.begin(), b.mines.end());
+    return a.rows == b.rows && a.cols == b.cols && a.mines == b.mines;
+}
+
+// Writes boards one after another and reads them all back
+bool round_trip(const BoardFormat format, const char* const name)
+{
+    const std::vector<Board> boards{
+        {1, 2, {1}},
+        {3, 5, {0, 4, 7, 10, 14}},
+        {9, 9, {}},
+        {16, 30, {479, 0, 31, 250}},
+        {255, 255, {65023, 254, 65024 - 254}},
+    };
+    std::FILE* const file = std::tmpfile();
+    for (const auto& board : boards)
+        write_board(file, board, format);
+    std::rewind(file);
+
+    BoardReader reader{file, format};
+    bool passed = true;
+    for (const auto& board : boards) {
+        const auto read = reader.next();
+        if (!read || !same(*read, board)) {
+            passed = fail(name, "board differs after a round trip");
+            break;
+        }
+    }
+    if (passed && reader.next())
+        passed = fail(name, "extra board read");
+    std::fclose(file);
+    return passed;
+}
+
+// Whether reading the input throws BadBoard, rather than anything else
+bool rejects(const BoardFormat format, const std::string& data)
+{
+    std::FILE* const file = file_of(data);
+    BoardReader reader{file, format};
+    bool rejected = false;
+    try {
+        while (reader.next()) {
+        }
+    } catch (const BadBoard&) {
+        rejected = true;
+    }
+    std::fclose(file);
+    return rejected;
+}
+}
+
+int main()
+{
+    bool passed = true;
+    passed = round_trip(BoardFormat::mbf, "mbf") && passed;
+    passed = round_trip(BoardFormat::grid, "grid") && passed;
+    passed = round_trip(BoardFormat::list, "list") && passed;
+
+    // Sizes and mine counts are checked before anything is allocated for
+    // them, so huge ones fail cleanly instead of running out of memory
+    const struct {
+        BoardFormat format;
+        std::string data;
+        const char* what;
+    } bad[]{
+        {BoardFormat::list, "3 3 2000000000", "huge mine count"},
+        {BoardFormat::list, "65536 65536 1 0 0", "board over INT_MAX cells"},
+        {BoardFormat::list, "0 3 0", "zero width"},
+        {BoardFormat::list, "2 2 4 0 0 1 0 0 1 1 1", "no safe cell"},
+        {BoardFormat::list, "3 3 1 3 0", "mine outside the board"},
+        {BoardFormat::list, "3 3 2 1 1 1 1", "two mines on one cell"},
+        {BoardFormat::list, "3 3 2 1 1", "truncated mines"},
+        {BoardFormat::mbf, std::string{"\xff\xff\xff\xff", 4},
+         "mbf count past the cells"},
+        {BoardFormat::mbf, std::string{"\0\5\0\0", 4}, "mbf zero width"},
+        {BoardFormat::mbf, std::string{"\2\2\0\1\5", 5}, "truncated mbf"},
+        {BoardFormat::grid, "..*\n..\n", "ragged grid"},
+        {BoardFormat::grid, "**\n**\n", "grid with no safe cell"},
+        {BoardFormat::grid, ".x.\n", "unexpected character"},
+    };
+    for (const auto& [format, data, what] : bad) {
+        if (!rejects(format, data))
+            passed = fail(what, "not rejected");
+    }
+
+    // Boards that don't fit mbf aren't written as something else
+    std::FILE* const file = std::tmpfile();
+    try {
+        write_board(file, Board{256, 2, {}}, BoardFormat::mbf);
+        passed = fail("mbf", "board too large written");
+    } catch (const BadBoard&) {
+    }
+    std::fclose(file);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,105 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "Corpus.hxx"
+#include "Game.hxx"
+
+namespace {
+using namespace termmine;
+
+bool fail(const char* what)
+{
+    std::fprintf(stderr, "%s\n", what);
+    return false;
+}
+
+bool rejects(const std::vector<unsigned char>& data, const std::size_t size)
+{
+    try {
+        CorpusView{data.data(), size};
+    } catch (const BadCorpus&) {
+        return true;
+    }
+    return false;
+}
+}
+
+// Packs boards laid out from their seeds, reads them back in place, and
+// checks that damaged corpora are refused
+int main()
+{
+    // A board whose bitset ends partway through a word
+    const CorpusHeader header{9, 11, 20, true, 50};
+    std::vector<unsigned char> data(corpus_file_size(header));
+    const std::size_t record_size = corpus_record_size(header.rows,
+                                                       header.cols);
+    write_corpus_header(data.data(), header);
+    std::vector<int> mines;
+    for (std::uint64_t i = 0; i < header.boards; ++i) {
+        Game::mine_layout(header.rows, header.cols, header.mines, 1000 + i,
+                          mines);
+        write_corpus_board(data.data() + corpus_header_size
+                           + i * record_size, header, 1000 + i, mines);
+    }
+
+    bool passed = true;
+    const CorpusView view{data.data(), data.size()};
+    const auto& read = view.header();
+    if (read.rows != header.rows || read.cols != header.cols
+        || read.mines != header.mines || read.no_guess != header.no_guess
+        || view.size() != header.boards)
+        passed = fail("header differs");
+    for (std::uint64_t i = 0; i < view.size() && passed; ++i) {
+        const Game game{header.rows, header.cols, header.mines, 1000 + i};
+        if (view.seed(i) != 1000 + i)
+            passed = fail("seed differs");
+        for (int row = 0; row < header.rows; ++row) {
+            for (int col = 0; col < header.cols; ++col) {
+                if (view.has_mine(i, row, col) != game.has_mine(row, col))
+                    passed = fail("mines differ");
+            }
+        }
+    }
+
+    if (!rejects(data, data.size() - 1))
+        passed = fail("truncated corpus read");
+    if (!rejects(data, corpus_header_size - 1))
+        passed = fail("truncated header read");
+    auto corrupt = data;
+    ++corrupt[24]; // the board count, under the header's checksum
+    if (!rejects(corrupt, corrupt.size()))
+        passed = fail("corrupt header read");
+
+    // A count too large to map saturates instead of wrapping
+    const CorpusHeader huge{1, 2, 1, false, UINT64_MAX / 8};
+    if (corpus_file_size(huge) != SIZE_MAX)
+        passed = fail("corpus size wrapped");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "Game.hxx"
+
+// Floods a board whose flags wall its one zero region into a single
+// serpentine corridor, the worst case for the flood that can't open the
+// region in one go. A recursive flood runs out of stack here.
+int main()
+{
+    using namespace termmine;
+    constexpr int rows = 1000;
+    constexpr int cols = 1000;
+    const std::vector<int> mines{(rows - 1) * cols};
+    Game game{rows, cols, mines};
+
+    // Every other row is a wall, with a gap at alternating ends
+    int flags = 0;
+    for (int i = 1; i < rows - 3; i += 2) {
+        const int gap = i / 2 % 2 == 0 ? cols - 1 : 0;
+        for (int j = 0; j < cols; ++j) {
+            if (j != gap) {
+                game.flag_cell(i, j);
+                ++flags;
+            }
+        }
+    }
+
+    game.open_cell(0, 0);
+    int opened = 0;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            if (game.is_open(i, j) && game.has_flag(i, j)) {
+                std::fprintf(stderr, "flagged cell %d,%d opened\n", i, j);
+                return EXIT_FAILURE;
+            }
+            opened += game.is_open(i, j);
+        }
+    }
+    if (game.is_over() || opened != rows * cols - 1 - flags) {
+        std::fprintf(stderr, "opened %d of %d cells\n", opened,
+                     rows * cols - 1 - flags);
+        return EXIT_FAILURE;
+    }
+
+    // With the walls lifted, opening one cell of each clears the board
+    for (int i = 1; i < rows - 3; i += 2) {
+        for (int j = 0; j < cols; ++j) {
+            if (game.has_flag(i, j))
+                game.flag_cell(i, j);
+        }
+        const int j = i / 2 % 2 == 0 ? 0 : cols - 1;
+        game.open_cell(i, j);
+        game.check_win(i, j);
+    }
+    if (!game.has_won()) {
+        std::fputs("board not cleared once the walls were lifted\n", stderr);
+        return EXIT_FAILURE;
+    }
+}
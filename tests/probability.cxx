@@ -0,0 +1,159 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <bit>
+#include <vector>
+
+#include "Game.hxx"
+#include "Probability.hxx"
+#include "ThreadPool.hxx"
+
+namespace {
+using namespace termmine;
+
+// Unknown cells past which there are too many layouts to count
+constexpr int max_unknown = 16;
+
+// Counts every layout of the mines left over the unknown cells that agrees
+// with the opened numbers, and how many of them mine each cell. Empty if
+// there are too many unknown cells.
+std::vector<double> brute_force(const Game& game)
+{
+    const int rows = game.rows();
+    const int cols = game.cols();
+    std::vector<int> unknown;
+    int flags = 0;
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        if (game.has_flag(cell / cols, cell % cols))
+            ++flags;
+        else if (!game.is_open(cell / cols, cell % cols))
+            unknown.push_back(cell);
+    }
+
+    if (unknown.size() > max_unknown)
+        return {};
+
+    const int mines_left = game.mines() - flags;
+    std::vector<double> mined(rows * cols, 0.0);
+    std::vector<char> mine(rows * cols, 0);
+    double layouts = 0;
+    for (std::uint32_t set = 0; set < 1u << unknown.size(); ++set) {
+        if (std::popcount(set) != mines_left)
+            continue;
+        for (std::size_t i = 0; i < unknown.size(); ++i)
+            mine[unknown[i]] = set >> i & 1;
+        for (int cell = 0; cell < rows * cols; ++cell) {
+            if (game.has_flag(cell / cols, cell % cols))
+                mine[cell] = 1;
+        }
+
+        bool valid = true;
+        for (int i = 0; i < rows && valid; ++i) {
+            for (int j = 0; j < cols && valid; ++j) {
+                if (!game.is_open(i, j))
+                    continue;
+                int around = 0;
+                for (int y = i - 1; y <= i + 1; ++y) {
+                    for (int x = j - 1; x <= j + 1; ++x) {
+                        if (y >= 0 && y < rows && x >= 0 && x < cols)
+                            around += mine[y * cols + x];
+                    }
+                }
+                valid = around == game.num_adj_mines(i, j);
+            }
+        }
+        if (!valid)
+            continue;
+        ++layouts;
+        for (const int cell : unknown)
+            mined[cell] += mine[cell];
+    }
+
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        if (game.has_flag(cell / cols, cell % cols))
+            mined[cell] = 1;
+        else
+            mined[cell] /= layouts;
+    }
+    return mined;
+}
+}
+
+// Checks the engine against every layout on small boards, opened a few
+// cells at a time so that they have frontiers and interiors of all shapes
+int main()
+{
+    ThreadPool pool{2};
+    ProbabilityEngine engine{pool};
+    constexpr int rows = 5;
+    constexpr int cols = 5;
+    int checked = 0;
+    for (std::uint_fast64_t seed = 0; seed < 300; ++seed) {
+        Game game{rows, cols, 6, seed};
+        int cell = seed % (rows * cols);
+        for (int step = 0; step < 4 && !game.is_over(); ++step) {
+            // A safe cell to open, and a mine to flag once the first open
+            // has settled where the mines are
+            while (game.is_open(cell / cols, cell % cols)
+                   || (step > 0 && game.has_mine(cell / cols, cell % cols)))
+                cell = (cell + 7) % (rows * cols);
+            game.open_cell(cell / cols, cell % cols);
+            game.check_win(cell / cols, cell % cols);
+            if (step == 1 && seed % 2 == 0) {
+                for (int mine = 0; mine < rows * cols; ++mine) {
+                    if (game.has_mine(mine / cols, mine % cols)) {
+                        game.flag_cell(mine / cols, mine % cols);
+                        break;
+                    }
+                }
+            }
+            if (game.is_over())
+                break;
+
+            const auto expected = brute_force(game);
+            if (expected.empty())
+                continue;
+            const auto probs = engine.compute(game);
+            for (int i = 0; i < rows * cols; ++i) {
+                if (std::abs(probs[i] - expected[i]) > 1e-9) {
+                    std::fprintf(stderr, "seed %d step %d: cell %d,%d is "
+                                 "%.12f, expected %.12f\n",
+                                 static_cast<int>(seed), step, i / cols,
+                                 i % cols, probs[i], expected[i]);
+                    return EXIT_FAILURE;
+                }
+            }
+            ++checked;
+        }
+    }
+    if (checked < 100) {
+        std::fprintf(stderr, "only %d positions checked\n", checked);
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "Replay.hxx"
+
+namespace {
+using namespace termmine;
+
+bool fail(const char* what)
+{
+    std::fprintf(stderr, "%s\n", what);
+    return false;
+}
+
+std::vector<unsigned char> read_file(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>{file}, {}};
+}
+}
+
+// Writes moves whose cell and time deltas take every varint length, both
+// signs of zigzag and every action, then reads them back
+int main()
+{
+    const std::string path = (std::filesystem::temp_directory_path()
+        / "termmine-test-replay.tmr").string();
+    const ReplayHeader header{1000, 2000, 12345, UINT64_MAX};
+    const std::vector<ReplayEvent> moves{
+        {Action::open, 500, 1000, 0},
+        {Action::flag, 500, 1001, 1},
+        {Action::mark, 500, 999, 200},
+        {Action::chord, 0, 0, 70'000},
+        {Action::open, 999, 1999, 20'000'000},
+        {Action::flag, 0, 1, std::int64_t{1} << 50},
+        {Action::open, 0, 1, (std::int64_t{1} << 50) + 1},
+    };
+    const ReplayEnd end{true, (std::int64_t{1} << 50) + 5};
+    {
+        ReplayWriter writer{path, header};
+        if (!writer.good()) {
+            std::fputs("cannot create replay\n", stderr);
+            return EXIT_FAILURE;
+        }
+        for (const auto& move : moves)
+            writer.record(move.action, move.row, move.col, move.time);
+        writer.finish(end.won, end.time);
+    }
+    const auto data = read_file(path);
+    std::filesystem::remove(path);
+
+    bool passed = true;
+    ReplayReader reader{data.data(), data.size()};
+    const auto& read = reader.header();
+    if (read.rows != header.rows || read.cols != header.cols
+        || read.mines != header.mines || read.seed != header.seed)
+        passed = fail("header differs");
+    for (const auto& move : moves) {
+        const auto event = reader.next();
+        if (!event || event->action != move.action || event->row != move.row
+            || event->col != move.col || event->time != move.time) {
+            passed = fail("move differs");
+            break;
+        }
+    }
+    if (reader.next() || !reader.end() || reader.end()->won != end.won
+        || reader.end()->time != end.time)
+        passed = fail("end differs");
+
+    // Cutting the file anywhere in its moves is caught
+    for (std::size_t size = 6; size < data.size(); ++size) {
+        try {
+            ReplayReader cut{data.data(), size};
+            while (cut.next()) {
+            }
+            passed = fail("truncated replay read");
+            break;
+        } catch (const BadReplay&) {
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
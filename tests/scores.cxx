@@ -0,0 +1,128 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "ScoreStore.hxx"
+
+namespace {
+using namespace termmine;
+
+bool fail(const char* what)
+{
+    std::fprintf(stderr, "%s\n", what);
+    return false;
+}
+
+GameRecord game(const std::int64_t time, const bool won)
+{
+    return GameRecord{16, 30, 99, false, 42, time, 130, won};
+}
+
+bool totals(const ScoreStore& store, const int games, const int wins,
+            const std::int64_t best)
+{
+    const BoardScores* const board = store.scores(16, 30, 99, false);
+    return board && board->games == games && board->wins == wins
+        && board->best && board->best->time == best;
+}
+
+void append(const std::filesystem::path& path, const std::string& bytes)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::app};
+    file << bytes;
+}
+}
+
+// Crashes are played out by tearing the log's last record and breaking its
+// index, which the store must notice and count every record again
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path()
+        / "termmine-test-scores";
+    std::filesystem::remove_all(dir);
+    const auto log = dir / "games.log";
+    bool passed = true;
+
+    {
+        ScoreStore store{dir.string()};
+        if (!store.good()) {
+            std::fputs("cannot create store\n", stderr);
+            return EXIT_FAILURE;
+        }
+        store.add(game(90'000, true));
+        store.add(game(5'000, false));
+        if (!store.add(game(60'000, true)))
+            passed = fail("new best time not reported");
+    }
+
+    // Half a record and a stale index
+    append(log, std::string(13, 'x'));
+    append(dir / "games.idx", "x");
+    {
+        ScoreStore store{dir.string()};
+        if (!totals(store, 3, 2, 60'000))
+            passed = fail("totals wrong after rebuilding the index");
+        store.add(game(75'000, true));
+    }
+    // A 16 byte header, then 32 byte records
+    if ((std::filesystem::file_size(log) - 16) % 32)
+        passed = fail("torn record not cut off");
+    {
+        ScoreStore store{dir.string()};
+        if (!totals(store, 4, 3, 60'000))
+            passed = fail("totals wrong after appending to a mended log");
+    }
+
+    // A record that fails its checksum is skipped
+    std::filesystem::remove(dir / "games.idx");
+    append(log, std::string(32, '\0'));
+    {
+        ScoreStore store{dir.string()};
+        if (!totals(store, 4, 3, 60'000))
+            passed = fail("corrupt record counted");
+    }
+
+    // Some other file in the store's place is left as it is
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    append(log, "not a score log at all, and not a whole record long");
+    const auto size = std::filesystem::file_size(log);
+    {
+        ScoreStore store{dir.string()};
+        if (store.good())
+            passed = fail("foreign log opened");
+    }
+    if (std::filesystem::file_size(log) != size)
+        passed = fail("foreign log cut");
+
+    std::filesystem::remove_all(dir);
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
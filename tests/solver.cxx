@@ -0,0 +1,97 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "Game.hxx"
+#include "Solver.hxx"
+
+namespace {
+using namespace termmine;
+
+bool fail(const char* what)
+{
+    std::fprintf(stderr, "%s\n", what);
+    return false;
+}
+
+// A 1-2-1 along the top row, with the rest of the board open: the two
+// mines are over the 1s' shared cells, and only subset reasoning finds the
+// safe cell between them
+bool one_two_one()
+{
+    Game game{4, 5, std::vector<int>{1, 3}};
+    game.open_cell(3, 0);
+    Solver solver{game};
+    solver.update();
+    if (!solver.is_mine(0, 1) || !solver.is_mine(0, 3))
+        return fail("1-2-1: mines not found");
+    for (const int col : {0, 2, 4}) {
+        if (!solver.is_safe(0, col))
+            return fail("1-2-1: safe cell not found");
+    }
+    if (solver.mines_found() != 2)
+        return fail("1-2-1: wrong number of mines found");
+
+    // Opening every safe cell it gives clears the board
+    while (const auto cell = solver.next_safe()) {
+        game.open_cell(cell->first, cell->second);
+        game.check_win(cell->first, cell->second);
+        solver.update();
+    }
+    return game.has_won() || fail("1-2-1: board not cleared");
+}
+
+// Two 1s sharing the same two unknown cells prove nothing, unless a flag on
+// one of them is trusted
+bool flags()
+{
+    Game game{2, 3, std::vector<int>{0}};
+    game.open_cell(1, 2);
+    game.flag_cell(0, 0);
+
+    Solver ignoring{game, false};
+    ignoring.update();
+    if (ignoring.is_mine(0, 0) || ignoring.next_safe())
+        return fail("flags: deduced from a flag it shouldn't trust");
+
+    Solver trusting{game, true};
+    trusting.update();
+    if (!trusting.is_safe(1, 0))
+        return fail("flags: flag not used");
+    return true;
+}
+}
+
+int main()
+{
+    // Every case runs, so one failure doesn't hide another
+    bool passed = true;
+    passed = one_two_one() && passed;
+    passed = flags() && passed;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,107 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifndef TERMMINE_MAPPEDFILE_HXX
+#define TERMMINE_MAPPEDFILE_HXX
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include <system_error>
+
+namespace termmine {
+// Maps a file into memory for as long as it is in scope
+class MappedFile final {
+public:
+    // Maps an existing file read-only
+    explicit MappedFile(const char* const path)
+    {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            throw std::system_error{errno, std::generic_category()};
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && info.st_size > 0)
+            map(fd, static_cast<std::size_t>(info.st_size), PROT_READ,
+                MAP_PRIVATE);
+        const int err = errno;
+        ::close(fd);
+        if (!data_ && size_ > 0)
+            throw std::system_error{err, std::generic_category()};
+    }
+
+    // Creates or truncates a file of the given size and maps it for writing
+    MappedFile(const char* const path, const std::size_t size)
+    {
+        const int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            throw std::system_error{errno, std::generic_category()};
+        if (::ftruncate(fd, static_cast<off_t>(size)) == 0 && size > 0)
+            map(fd, size, PROT_READ | PROT_WRITE, MAP_SHARED);
+        const int err = errno;
+        ::close(fd);
+        if (!data_)
+            throw std::system_error{err, std::generic_category()};
+    }
+
+    ~MappedFile()
+    {
+        if (data_)
+            ::munmap(data_, size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const noexcept { return data_; }
+    // Only writable if the file was mapped for writing
+    unsigned char* data() noexcept { return data_; }
+    std::size_t size() const noexcept { return data_ ? size_ : 0; }
+
+    // Writes a writable mapping through to the disk
+    bool sync() noexcept
+    {
+        return ::msync(data_, size_, MS_SYNC) == 0;
+    }
+
+private:
+    unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    void map(const int fd, const std::size_t size, const int protection,
+             const int flags) noexcept
+    {
+        size_ = size;
+        void* const data = ::mmap(nullptr, size, protection, flags, fd, 0);
+        if (data != MAP_FAILED)
+            data_ = static_cast<unsigned char*>(data);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,270 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "Corpus.hxx"
+#include "Game.hxx"
+#include "Generator.hxx"
+#include "MappedFile.hxx"
+#include "ThreadPool.hxx"
+
+namespace {
+using namespace termmine;
+
+// Larger boards are rejected so a record stays small
+constexpr int max_cells = 1 << 20;
+
+struct Settings {
+    std::string file;
+    bool check = false;
+    std::uint64_t boards = 1'000'000;
+    int rows = 16;
+    int cols = 30;
+    int mines = 99;
+    std::uint_fast64_t seed = 0;
+    bool no_guess = false;
+    unsigned threads = 0;
+};
+
+const char* const usage =
+    "Usage: termmine-corpus [options] <file>\n"
+    "  --boards <n>     Boards to generate (default 1000000)\n"
+    "  --rows <n>       Rows of each board (default 16)\n"
+    "  --cols <n>       Columns of each board (default 30)\n"
+    "  --mines <n>      Mines on each board (default 99)\n"
+    "  --seed <n>       Seed of the first board (default 0)\n"
+    "  --no-guess       Only boards from the no-guess generator, failing if\n"
+    "                   it finds none for a seed\n"
+    "  --threads <n>    Worker threads, 0 for one per core (default 0)\n"
+    "  --check          Check an existing corpus against its seeds instead\n";
+
+template <typename T>
+T parse_num(const std::string_view arg, const char* const value)
+{
+    const std::string_view text{value};
+    T num{};
+    const auto [end, ec] = std::from_chars(text.data(),
+                                           text.data() + text.size(), num);
+    if (ec != std::errc{} || end != text.data() + text.size())
+        throw std::invalid_argument{"invalid value for " + std::string{arg}
+            + ": " + std::string{text}};
+    return num;
+}
+
+Settings parse_settings(const int argc, const char* const argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (!arg.starts_with("--")) {
+            if (!settings.file.empty())
+                throw std::invalid_argument{"more than one file given"};
+            settings.file = arg;
+            continue;
+        }
+        if (arg == "--check") {
+            settings.check = true;
+            continue;
+        }
+        if (arg == "--no-guess") {
+            settings.no_guess = true;
+            continue;
+        }
+
+        if (++i == argc)
+            throw std::invalid_argument{"missing value for "
+                + std::string{arg}};
+        if (arg == "--boards") {
+            settings.boards = parse_num<std::uint64_t>(arg, argv[i]);
+        } else if (arg == "--rows") {
+            settings.rows = parse_num<int>(arg, argv[i]);
+        } else if (arg == "--cols") {
+            settings.cols = parse_num<int>(arg, argv[i]);
+        } else if (arg == "--mines") {
+            settings.mines = parse_num<int>(arg, argv[i]);
+        } else if (arg == "--seed") {
+            settings.seed = parse_num<std::uint_fast64_t>(arg, argv[i]);
+        } else if (arg == "--threads") {
+            settings.threads = parse_num<unsigned>(arg, argv[i]);
+        } else {
+            throw std::invalid_argument{"unknown option: "
+                + std::string{arg}};
+        }
+    }
+    if (settings.file.empty())
+        throw std::invalid_argument{"no file given"};
+    if (settings.rows <= 0 || settings.cols <= 0
+        || settings.rows > max_cells / settings.cols)
+        throw std::invalid_argument{"invalid board size"};
+    if (settings.mines < 0 || settings.mines >= settings.rows * settings.cols)
+        throw std::invalid_argument{"invalid mine count"};
+    // The whole corpus is mapped, so its size has to fit in memory
+    if (settings.boards > (SIZE_MAX - corpus_header_size)
+        / corpus_record_size(settings.rows, settings.cols))
+        throw std::invalid_argument{"too many boards for one file"};
+    return settings;
+}
+
+// Runs body(first, last) over contiguous runs of boards on every worker
+template <typename Body>
+void for_chunks(ThreadPool& pool, const std::uint64_t boards, Body&& body)
+{
+    const std::size_t chunks = static_cast<std::size_t>(
+        std::min<std::uint64_t>(boards, pool.size() * 16));
+    pool.parallel_for(chunks, [&](const std::size_t chunk) {
+        body(boards * chunk / chunks, boards * (chunk + 1) / chunks);
+    });
+}
+
+/*
+* Each worker lays out its boards as Game does and writes them straight into
+* the mapped file. The header goes in last, so a file left behind by a failed
+* run is never mistaken for a corpus.
+*/
+void generate(const Settings& settings, ThreadPool& pool)
+{
+    const CorpusHeader header{settings.rows, settings.cols, settings.mines,
+                              settings.no_guess, settings.boards};
+    const std::size_t record_size = corpus_record_size(header.rows,
+                                                       header.cols);
+    MappedFile file{settings.file.c_str(), corpus_file_size(header)};
+    unsigned char* const records = file.data() + corpus_header_size;
+
+    // Set once a no-guess search gives up, which stops the other workers
+    std::atomic<bool> failed{false};
+    for_chunks(pool, settings.boards, [&](const std::uint64_t first,
+                                          const std::uint64_t last) {
+        // The generator's stats aren't shared between threads
+        NoGuessGenerator generator{pool};
+        for (std::uint64_t i = first; i < last; ++i) {
+            if (failed.load(std::memory_order_relaxed))
+                return;
+            std::uint_fast64_t seed = settings.seed + i;
+            if (settings.no_guess) {
+                const auto found = generator.find_seed(
+                    header.rows, header.cols, header.mines, seed);
+                if (!found) {
+                    failed.store(true, std::memory_order_relaxed);
+                    return;
+                }
+                seed = *found;
+            }
+            write_corpus_board(records + i * record_size, header, seed,
+                               Game::mine_layout(header.rows, header.cols,
+                                                 header.mines, seed));
+        }
+    });
+    // A record that may need guessing would contradict the header
+    if (failed)
+        throw std::runtime_error{"no board solvable without guessing found; "
+                                 "try fewer mines"};
+
+    write_corpus_header(file.data(), header);
+    if (!file.sync())
+        throw std::system_error{errno, std::generic_category()};
+}
+
+// Counts the boards whose mines aren't the ones their seed lays
+std::uint64_t check(const Settings& settings, ThreadPool& pool)
+{
+    const MappedFile file{settings.file.c_str()};
+    const CorpusView corpus{file.data(), file.size()};
+    const CorpusHeader& header = corpus.header();
+    if (header.rows > max_cells / header.cols)
+        throw BadCorpus{"Board too large to check"};
+
+    std::atomic<std::uint64_t> bad{0};
+    for_chunks(pool, corpus.size(), [&](const std::uint64_t first,
+                                        const std::uint64_t last) {
+        std::vector<unsigned char> expected(
+            corpus_record_size(header.rows, header.cols));
+        for (std::uint64_t i = first; i < last; ++i) {
+            const std::uint_fast64_t seed = corpus.seed(i);
+            write_corpus_board(expected.data(), header, seed,
+                               Game::mine_layout(header.rows, header.cols,
+                                                 header.mines, seed));
+            if (std::memcmp(expected.data() + 8, corpus.mine_bits(i),
+                            expected.size() - 8) != 0)
+                ++bad;
+        }
+    });
+    return bad;
+}
+}
+
+/*
+* Generates boards on every core into one packed corpus file that other
+* programs can map and index without parsing, or checks an existing one.
+*/
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    try {
+        settings = parse_settings(argc, argv);
+    } catch (const std::invalid_argument& err) {
+        std::fprintf(stderr, "termmine-corpus: %s\n%s", err.what(), usage);
+        return 1;
+    }
+
+    ThreadPool pool{settings.threads};
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        if (settings.check) {
+            const std::uint64_t bad = check(settings, pool);
+            const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+            std::fprintf(stderr, "%llu boards don't match their seeds, "
+                         "%.1f s\n", static_cast<unsigned long long>(bad),
+                         seconds);
+            return bad > 0 ? 2 : 0;
+        }
+        generate(settings, pool);
+    } catch (const std::exception& err) {
+        std::fprintf(stderr, "termmine-corpus: %s: %s\n",
+                     settings.file.c_str(), err.what());
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%llu boards, %.0f boards/s\n",
+                 static_cast<unsigned long long>(settings.boards),
+                 seconds > 0 ? settings.boards / seconds : 0.0);
+    return 0;
+}
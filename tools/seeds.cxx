@@ -0,0 +1,343 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "Game.hxx"
+#include "Generator.hxx"
+#include "ThreadPool.hxx"
+
+namespace {
+using namespace termmine;
+
+// Seeds each worker takes at a time, enough to make taking them cheap
+constexpr std::uint64_t block_size = 4096;
+
+struct Settings {
+    int rows = 9;
+    int cols = 9;
+    int mines = 10;
+    std::uint_fast64_t seed = 0;
+    std::uint64_t count = 100'000'000;
+    std::uint64_t limit = 0;
+    std::optional<std::pair<int, int>> click;
+    int min_3bv = 0;
+    int max_3bv = std::numeric_limits<int>::max();
+    int min_opening = 0;
+    bool no_guess = false;
+    unsigned threads = 0;
+};
+
+const char* const usage =
+    "Usage: termmine-seeds [options]\n"
+    "  --rows <n>         Rows of each board (default 9)\n"
+    "  --cols <n>         Columns of each board (default 9)\n"
+    "  --mines <n>        Mines on each board (default 10)\n"
+    "  --seed <n>         First seed to try (default 0)\n"
+    "  --count <n>        Seeds to try (default 100000000)\n"
+    "  --limit <n>        Stop after n matches, 0 for no limit (default 0)\n"
+    "  --click <row,col>  First click (default the middle cell)\n"
+    "  --min-3bv <n>      Only boards with a 3BV of at least n\n"
+    "  --max-3bv <n>      Only boards with a 3BV of at most n\n"
+    "  --min-opening <n>  Only boards whose first click opens n cells\n"
+    "  --no-guess         Only boards solvable from the first click\n"
+    "  --threads <n>      Worker threads, 0 for one per core (default 0)\n"
+    "Prints each matching seed as soon as it is found, not in order.\n";
+
+template <typename T>
+T parse_num(const std::string_view arg, const std::string_view text)
+{
+    T num{};
+    const auto [end, ec] = std::from_chars(text.data(),
+                                           text.data() + text.size(), num);
+    if (ec != std::errc{} || end != text.data() + text.size())
+        throw std::invalid_argument{"invalid value for " + std::string{arg}
+            + ": " + std::string{text}};
+    return num;
+}
+
+Settings parse_settings(const int argc, const char* const argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--no-guess") {
+            settings.no_guess = true;
+            continue;
+        }
+
+        if (++i == argc)
+            throw std::invalid_argument{"missing value for "
+                + std::string{arg}};
+        const std::string_view value{argv[i]};
+        if (arg == "--rows") {
+            settings.rows = parse_num<int>(arg, value);
+        } else if (arg == "--cols") {
+            settings.cols = parse_num<int>(arg, value);
+        } else if (arg == "--mines") {
+            settings.mines = parse_num<int>(arg, value);
+        } else if (arg == "--seed") {
+            settings.seed = parse_num<std::uint_fast64_t>(arg, value);
+        } else if (arg == "--count") {
+            settings.count = parse_num<std::uint64_t>(arg, value);
+        } else if (arg == "--limit") {
+            settings.limit = parse_num<std::uint64_t>(arg, value);
+        } else if (arg == "--click") {
+            const std::size_t comma = value.find(',');
+            if (comma == std::string_view::npos)
+                throw std::invalid_argument{"invalid value for --click: "
+                    + std::string{value}};
+            settings.click = {parse_num<int>(arg, value.substr(0, comma)),
+                              parse_num<int>(arg, value.substr(comma + 1))};
+        } else if (arg == "--min-3bv") {
+            settings.min_3bv = parse_num<int>(arg, value);
+        } else if (arg == "--max-3bv") {
+            settings.max_3bv = parse_num<int>(arg, value);
+        } else if (arg == "--min-opening") {
+            settings.min_opening = parse_num<int>(arg, value);
+        } else if (arg == "--threads") {
+            settings.threads = parse_num<unsigned>(arg, value);
+        } else {
+            throw std::invalid_argument{"unknown option: "
+                + std::string{arg}};
+        }
+    }
+    if (settings.rows <= 0 || settings.cols <= 0
+        || settings.rows > std::numeric_limits<int>::max() / settings.cols)
+        throw std::invalid_argument{"invalid board size"};
+    if (settings.mines < 0 || settings.mines >= settings.rows * settings.cols)
+        throw std::invalid_argument{"invalid mine count"};
+    if (!settings.click)
+        settings.click = NoGuessGenerator::start_cell(settings.rows,
+                                                      settings.cols);
+    const auto [row, col] = *settings.click;
+    if (row < 0 || row >= settings.rows || col < 0 || col >= settings.cols)
+        throw std::invalid_argument{"click outside the board"};
+    return settings;
+}
+
+struct Match {
+    std::uint_fast64_t seed;
+    int bbbv;
+    int opening;
+};
+
+/*
+* Tests seeds against the settings, cheapest checks first. The mine layout
+* is the one Game lays, and its 3BV and first opening are worked out here
+* on flat arrays the way Game labels its regions, so only seeds still
+* matching after those reach the solver. A mine under the click is rejected
+* outright, as Game would move it and change the board.
+*/
+class Evaluator final {
+public:
+    explicit Evaluator(const Settings& settings)
+        : settings_{settings},
+          count_(std::size_t(settings.rows) * settings.cols),
+          seen_(count_.size()),
+          stack_(count_.size()),
+          first_neighbour_(count_.size() + 1)
+    {
+        // Each cell's neighbours, from first_neighbour_[cell] up to
+        // first_neighbour_[cell + 1]
+        for (int cell = 0; cell < static_cast<int>(count_.size()); ++cell) {
+            const int row = cell / settings.cols;
+            const int col = cell % settings.cols;
+            for (int y = std::max(row - 1, 0);
+                 y <= std::min(row + 1, settings.rows - 1); ++y) {
+                for (int x = std::max(col - 1, 0);
+                     x <= std::min(col + 1, settings.cols - 1); ++x) {
+                    if (y != row || x != col)
+                        neighbours_.push_back(y * settings.cols + x);
+                }
+            }
+            first_neighbour_[cell + 1] = static_cast<int>(neighbours_.size());
+        }
+        const auto [row, col] = *settings.click;
+        click_ = row * settings.cols + col;
+    }
+
+    std::optional<Match> evaluate(const std::uint_fast64_t seed)
+    {
+        const Settings& s = settings_;
+        Game::mine_layout(s.rows, s.cols, s.mines, seed, mines_);
+
+        // Mines are marked by a count past any real one
+        std::ranges::fill(count_, 0);
+        for (const int mine : mines_)
+            count_[mine] = mine_mark;
+        if (count_[click_] == mine_mark)
+            return std::nullopt;
+        for (const int mine : mines_) {
+            for (int i = first_neighbour_[mine];
+                 i < first_neighbour_[mine + 1]; ++i)
+                ++count_[neighbours_[i]];
+        }
+        if (s.min_opening > 1 && count_[click_] != 0)
+            return std::nullopt;
+
+        std::ranges::fill(seen_, false);
+        const int opening = count_[click_] == 0 ? open_from(click_) : 1;
+        if (opening < s.min_opening)
+            return std::nullopt;
+
+        // One click for each region of zeros, the click's included, and
+        // one for each number no region borders
+        int bbbv = count_[click_] == 0;
+        for (int cell = 0; cell < static_cast<int>(count_.size()); ++cell) {
+            if (count_[cell] == 0 && !seen_[cell]) {
+                open_from(cell);
+                ++bbbv;
+            }
+        }
+        for (int cell = 0; cell < static_cast<int>(count_.size()); ++cell)
+            bbbv += !seen_[cell] && count_[cell] < mine_mark;
+        if (bbbv < s.min_3bv || bbbv > s.max_3bv)
+            return std::nullopt;
+
+        const auto [row, col] = *s.click;
+        if (s.no_guess
+            && !solvable_without_guessing(Game{s.rows, s.cols, s.mines, seed},
+                                          row, col))
+            return std::nullopt;
+        return Match{seed, bbbv, opening};
+    }
+
+private:
+    static constexpr unsigned char mine_mark = 9;
+
+    const Settings& settings_;
+    int click_ = 0;
+    std::vector<int> mines_;
+    std::vector<unsigned char> count_;
+    std::vector<char> seen_;
+    std::vector<int> stack_;
+    std::vector<int> first_neighbour_;
+    std::vector<int> neighbours_;
+
+    // Marks the region of zeros holding cell and its border as seen, and
+    // returns how many cells that is
+    int open_from(const int cell)
+    {
+        int opened = 1;
+        int top = 0;
+        seen_[cell] = true;
+        stack_[top++] = cell;
+        while (top > 0) {
+            const int zero = stack_[--top];
+            for (int i = first_neighbour_[zero];
+                 i < first_neighbour_[zero + 1]; ++i) {
+                const int next = neighbours_[i];
+                if (seen_[next])
+                    continue;
+                seen_[next] = true;
+                ++opened;
+                if (count_[next] == 0)
+                    stack_[top++] = next;
+            }
+        }
+        return opened;
+    }
+};
+}
+
+/*
+* Scans a range of seeds on every core for boards with the wanted 3BV, first
+* opening or no-guess solvability, and prints each match as it is found, so
+* the seeds can be played in the custom board menu.
+*/
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    try {
+        settings = parse_settings(argc, argv);
+    } catch (const std::invalid_argument& err) {
+        std::fprintf(stderr, "termmine-seeds: %s\n%s", err.what(), usage);
+        return 1;
+    }
+
+    ThreadPool pool{settings.threads};
+    std::atomic<std::uint64_t> next_block{0};
+    std::atomic<std::uint64_t> scanned{0};
+    std::atomic<std::uint64_t> matches{0};
+    std::mutex out_mutex;
+    const std::uint64_t blocks = (settings.count + block_size - 1)
+        / block_size;
+    auto done = [&] {
+        return settings.limit > 0
+            && matches.load(std::memory_order_relaxed) >= settings.limit;
+    };
+
+    std::fputs("seed,3bv,opening\n", stdout);
+    std::fflush(stdout);
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallel_for(pool.size(), [&](std::size_t) {
+        Evaluator evaluator{settings};
+        for (std::uint64_t block = next_block++; block < blocks && !done();
+             block = next_block++) {
+            const std::uint64_t first = block * block_size;
+            const std::uint64_t last = std::min(first + block_size,
+                                                settings.count);
+            std::uint64_t i = first;
+            for (; i < last; ++i) {
+                const auto match = evaluator.evaluate(settings.seed + i);
+                if (!match)
+                    continue;
+                const std::lock_guard lock{out_mutex};
+                if (done())
+                    break;
+                ++matches;
+                std::printf("%llu,%d,%d\n",
+                            static_cast<unsigned long long>(match->seed),
+                            match->bbbv, match->opening);
+                std::fflush(stdout);
+            }
+            scanned += i - first;
+        }
+    });
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::fprintf(stderr, "%llu seeds, %llu matches, %.0f seeds/s\n",
+                 static_cast<unsigned long long>(scanned.load()),
+                 static_cast<unsigned long long>(matches.load()),
+                 seconds > 0 ? scanned / seconds : 0.0);
+    return 0;
+}
@@ -0,0 +1,469 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "BoardFormat.hxx"
+#include "Game.hxx"
+#include "Generator.hxx"
+#include "Instrument.hxx"
+#include "Probability.hxx"
+#include "Solver.hxx"
+#include "ThreadPool.hxx"
+
+namespace {
+using namespace termmine;
+
+struct Preset {
+    const char* name;
+    int rows;
+    int cols;
+    int mines;
+};
+
+// Decides which cell a bot opens next
+class Policy {
+public:
+    virtual ~Policy() = default;
+    // The next cell to open, or nothing to give up
+    virtual std::optional<std::pair<int, int>> next() = 0;
+};
+
+// Only opens cells the solver proves safe
+class SolverPolicy final : public Policy {
+public:
+    explicit SolverPolicy(const Game& game) : solver_{game, false} {}
+
+    std::optional<std::pair<int, int>> next() override
+    {
+        solver_.update();
+        return solver_.next_safe();
+    }
+
+private:
+    Solver solver_;
+};
+
+// Opens proven safe cells, then guesses the cell least likely to be a mine
+class GuessPolicy final : public Policy {
+public:
+    GuessPolicy(const Game& game, ThreadPool& pool)
+        : game_{game}, solver_{game, false}, engine_{pool, false}
+    {
+    }
+
+    std::optional<std::pair<int, int>> next() override
+    {
+        solver_.update();
+        if (const auto safe = solver_.next_safe())
+            return safe;
+
+        auto probs = engine_.compute(game_);
+        if (probs.empty())
+            probs = estimate_probabilities(game_, false);
+        return safest_cell(game_, probs);
+    }
+
+private:
+    const Game& game_;
+    Solver solver_;
+    ProbabilityEngine engine_;
+};
+
+// Opens any unopened cell, as a baseline
+class RandomPolicy final : public Policy {
+public:
+    RandomPolicy(const Game& game, const std::uint_fast64_t seed)
+        : game_{game}, gen_{seed}
+    {
+    }
+
+    std::optional<std::pair<int, int>> next() override
+    {
+        std::vector<std::pair<int, int>> closed;
+        for (int i = 0; i < game_.rows(); ++i) {
+            for (int j = 0; j < game_.cols(); ++j) {
+                if (!game_.is_open(i, j))
+                    closed.emplace_back(i, j);
+            }
+        }
+        if (closed.empty())
+            return std::nullopt;
+        return closed[std::uniform_int_distribution<std::size_t>{
+            0, closed.size() - 1}(gen_)];
+    }
+
+private:
+    const Game& game_;
+    std::mt19937_64 gen_;
+};
+
+constexpr std::array policy_names{"solver", "guess", "random"};
+
+std::unique_ptr<Policy> make_policy(const std::string_view name,
+                                    const Game& game, ThreadPool& pool)
+{
+    if (name == "solver")
+        return std::make_unique<SolverPolicy>(game);
+    if (name == "guess")
+        return std::make_unique<GuessPolicy>(game, pool);
+    return std::make_unique<RandomPolicy>(game, game.seed());
+}
+
+// Counts of open_cell() times by power of two nanoseconds
+struct Histogram {
+    static constexpr int buckets = 40;
+    std::array<std::uint64_t, buckets> counts{};
+
+    void add(const std::chrono::nanoseconds time) noexcept
+    {
+        int bucket = 0;
+        for (auto ns = time.count(); ns > 1 && bucket < buckets - 1; ns >>= 1)
+            ++bucket;
+        ++counts[bucket];
+    }
+
+    void merge(const Histogram& other) noexcept
+    {
+        for (int i = 0; i < buckets; ++i)
+            counts[i] += other.counts[i];
+    }
+
+    std::uint64_t total() const noexcept
+    {
+        std::uint64_t sum = 0;
+        for (const auto count : counts)
+            sum += count;
+        return sum;
+    }
+
+    // Upper bound of the bucket holding the given fraction of samples
+    std::uint64_t percentile(const double fraction) const noexcept
+    {
+        const double target = fraction * total();
+        std::uint64_t seen = 0;
+        for (int i = 0; i < buckets; ++i) {
+            seen += counts[i];
+            if (seen > 0 && seen >= target)
+                return std::uint64_t{2} << i;
+        }
+        return std::uint64_t{2} << (buckets - 1);
+    }
+};
+
+struct Settings {
+    int games = 1000;
+    unsigned threads = 0;
+    std::string_view policy = "solver";
+    std::uint_fast64_t seed = 0;
+    bool no_guess = false;
+    bool histogram = false;
+    // Files of boards to play instead of the presets, and to write every
+    // board dealt to, in the format or else the one their names suggest
+    std::string boards;
+    std::string export_file;
+    std::optional<BoardFormat> format;
+};
+
+const char* const usage =
+    "Usage: termmine-sim [options]\n"
+    "  --games <n>      Games per difficulty (default 1000)\n"
+    "  --threads <n>    Worker threads, 0 for one per core (default 0)\n"
+    "  --policy <name>  Bot: solver, guess or random (default solver)\n"
+    "  --seed <n>       Seed of the first game (default 0)\n"
+    "  --no-guess       Play boards from the no-guess generator\n"
+    "  --histogram      Print the open_cell latency histogram\n"
+    "  --boards <file>  Play the boards in file instead of the presets\n"
+    "  --export <file>  Write every board dealt to file\n"
+    "  --format <name>  Board file format: mbf, grid or list (default mbf\n"
+    "                   for .mbf files, list for .list files, else grid)\n";
+
+template <typename T>
+T parse_num(const std::string_view arg, const char* const value)
+{
+    const std::string_view text{value};
+    T num{};
+    const auto [end, ec] = std::from_chars(text.data(),
+                                           text.data() + text.size(), num);
+    if (ec != std::errc{} || end != text.data() + text.size())
+        throw std::invalid_argument{"invalid value for " + std::string{arg}
+            + ": " + std::string{text}};
+    return num;
+}
+
+Settings parse_settings(const int argc, const char* const argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg == "--no-guess") {
+            settings.no_guess = true;
+            continue;
+        }
+        if (arg == "--histogram") {
+            settings.histogram = true;
+            continue;
+        }
+
+        if (++i == argc)
+            throw std::invalid_argument{"missing value for "
+                + std::string{arg}};
+        if (arg == "--games") {
+            settings.games = parse_num<int>(arg, argv[i]);
+            if (settings.games <= 0)
+                throw std::invalid_argument{"--games must be positive"};
+        } else if (arg == "--threads") {
+            settings.threads = parse_num<unsigned>(arg, argv[i]);
+        } else if (arg == "--policy") {
+            settings.policy = argv[i];
+            if (std::ranges::find(policy_names, settings.policy)
+                == policy_names.end())
+                throw std::invalid_argument{"unknown policy: "
+                    + std::string{settings.policy}};
+        } else if (arg == "--seed") {
+            settings.seed = parse_num<std::uint_fast64_t>(arg, argv[i]);
+        } else if (arg == "--boards") {
+            settings.boards = argv[i];
+        } else if (arg == "--export") {
+            settings.export_file = argv[i];
+        } else if (arg == "--format") {
+            settings.format = board_format(argv[i]);
+            if (!settings.format)
+                throw std::invalid_argument{"unknown format: "
+                    + std::string{argv[i]}};
+        } else {
+            throw std::invalid_argument{"unknown option: "
+                + std::string{arg}};
+        }
+    }
+    return settings;
+}
+
+BoardFormat format_for(const Settings& settings, const std::string_view path)
+{
+    if (settings.format)
+        return *settings.format;
+    if (path.ends_with(".mbf"))
+        return BoardFormat::mbf;
+    if (path.ends_with(".list"))
+        return BoardFormat::list;
+    return BoardFormat::grid;
+}
+
+std::vector<Board> read_boards(const Settings& settings)
+{
+    std::FILE* const in = std::fopen(settings.boards.c_str(), "rb");
+    if (!in)
+        throw BadBoard{"Cannot open the boards file"};
+    std::vector<Board> boards;
+    try {
+        BoardReader reader{in, format_for(settings, settings.boards)};
+        while (auto board = reader.next())
+            boards.push_back(std::move(*board));
+    } catch (...) {
+        std::fclose(in);
+        throw;
+    }
+    std::fclose(in);
+    return boards;
+}
+
+// Appends boards to the export file, if there is one
+void export_boards(const Settings& settings, const std::vector<Board>& boards)
+{
+    if (settings.export_file.empty())
+        return;
+    std::FILE* const out = std::fopen(settings.export_file.c_str(), "ab");
+    if (!out)
+        throw BadBoard{"Cannot open the export file"};
+    const BoardFormat format = format_for(settings, settings.export_file);
+    try {
+        for (const auto& board : boards)
+            write_board(out, board, format);
+    } catch (...) {
+        std::fclose(out);
+        throw;
+    }
+    std::fclose(out);
+}
+
+// Plays games boards dealt by deal(i) and prints a row of stats, keeping the
+// boards in dealt if they are to be exported
+template <typename Deal>
+void play_deck(const char* const name, const std::size_t games,
+               ThreadPool& pool, const Settings& settings,
+               std::vector<Board>& dealt, Deal&& deal)
+{
+    if (games == 0)
+        return;
+    if (!settings.export_file.empty())
+        dealt.resize(games);
+
+    // Each chunk of games has its own histogram to avoid sharing
+    const std::size_t chunks = std::min<std::size_t>(games, pool.size() * 16);
+    std::vector<Histogram> histograms(chunks);
+    std::atomic<int> won{0};
+    std::atomic<long long> total_3bv{0};
+
+    const auto start = std::chrono::steady_clock::now();
+    pool.parallel_for(chunks, [&](const std::size_t chunk) {
+        Histogram& histogram = histograms[chunk];
+        for (std::size_t i = chunk; i < games; i += chunks) {
+            Game game{deal(i)};
+
+            const auto policy = make_policy(settings.policy, game, pool);
+            auto [row, col] = NoGuessGenerator::start_cell(game.rows(),
+                                                           game.cols());
+            while (true) {
+                const auto before = std::chrono::steady_clock::now();
+                game.open_cell(row, col);
+                histogram.add(std::chrono::steady_clock::now() - before);
+                game.check_win(row, col);
+                if (game.is_over())
+                    break;
+
+                const auto cell = policy->next();
+                if (!cell)
+                    break;
+                row = cell->first;
+                col = cell->second;
+            }
+            total_3bv += game.bbbv();
+            won += game.has_won();
+            // Mines only settle once the first cell is open
+            if (!dealt.empty())
+                dealt[i] = board_of(game);
+        }
+    });
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    Histogram histogram;
+    for (const auto& part : histograms)
+        histogram.merge(part);
+    std::printf("%-14s %8zu %7.2f%% %10.2f %10.0f %8lluns %8lluns %8lluns\n",
+                name, games, 100.0 * won / games,
+                static_cast<double>(total_3bv) / games, games / seconds,
+                static_cast<unsigned long long>(histogram.percentile(0.5)),
+                static_cast<unsigned long long>(histogram.percentile(0.99)),
+                static_cast<unsigned long long>(histogram.percentile(1)));
+
+    if (!settings.histogram)
+        return;
+    for (int i = 0; i < Histogram::buckets; ++i) {
+        if (histogram.counts[i] == 0)
+            continue;
+        std::printf("  < %10llu ns %12llu\n",
+                    static_cast<unsigned long long>(std::uint64_t{2} << i),
+                    static_cast<unsigned long long>(histogram.counts[i]));
+    }
+}
+}
+
+/*
+* Plays games without a terminal on every core, with a bot choosing the cells
+* to open, so generator and solver changes can be compared in bulk.
+*/
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    try {
+        settings = parse_settings(argc, argv);
+    } catch (const std::invalid_argument& err) {
+        std::fprintf(stderr, "termmine-sim: %s\n%s", err.what(), usage);
+        return 1;
+    }
+
+    constexpr std::array<Preset, 3> presets{{
+        {"Beginner", 9, 9, 10},
+        {"Intermediate", 16, 16, 40},
+        {"Advanced", 16, 30, 99}
+    }};
+
+    ThreadPool pool{settings.threads};
+    std::printf("Policy: %s  Threads: %u%s\n",
+                std::string{settings.policy}.c_str(), pool.size(),
+                settings.no_guess ? "  No-guess boards" : "");
+    std::printf("%-14s %8s %8s %10s %10s %10s %10s %10s\n", "Difficulty",
+                "Games", "Won", "Mean 3BV", "Games/s", "Open p50", "Open p99",
+                "Open max");
+
+    try {
+        if (!settings.boards.empty()) {
+            // Bots play the imported boards instead of the presets
+            const std::vector<Board> boards = read_boards(settings);
+            std::vector<Board> dealt;
+            play_deck("Imported", boards.size(), pool, settings, dealt,
+                      [&boards](const std::size_t i) {
+                          return Game{boards[i].rows, boards[i].cols,
+                                      boards[i].mines};
+                      });
+            export_boards(settings, dealt);
+        }
+        for (const auto& preset : settings.boards.empty()
+                 ? std::span{presets} : std::span<const Preset>{}) {
+            std::vector<Board> dealt;
+            play_deck(preset.name, settings.games, pool, settings, dealt,
+                      [&](const std::size_t i) {
+                std::uint_fast64_t seed = settings.seed + i;
+                if (settings.no_guess) {
+                    // The generator's stats aren't shared between threads
+                    NoGuessGenerator generator{pool};
+                    seed = generator.find_seed(preset.rows, preset.cols,
+                                               preset.mines, seed)
+                        .value_or(seed);
+                }
+                return Game{preset.rows, preset.cols, preset.mines, seed};
+            });
+            export_boards(settings, dealt);
+        }
+    } catch (const BadBoard& err) {
+        std::fprintf(stderr, "termmine-sim: %s\n", err.what());
+        return 1;
+    }
+
+#ifdef TERMMINE_INSTRUMENT
+    std::printf("%s\n", instrument::stats_line().c_str());
+#endif
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+/*
+* MIT License
+*
+* Copyright (c) 2021 Eric Wan
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "Game.hxx"
+#include "MappedFile.hxx"
+#include "Replay.hxx"
+#include "ThreadPool.hxx"
+
+namespace {
+using namespace termmine;
+
+// Larger boards are rejected rather than allocated
+constexpr int max_cells = 1 << 20;
+
+struct Result {
+    // Empty if the replay is consistent
+    std::string error;
+    ReplayHeader header{};
+    bool won = false;
+    std::int64_t time = 0;
+    int bbbv = 0;
+    int solved_bbbv = 0;
+    int clicks = 0;
+};
+
+/*
+* Replays the moves on a fresh game from the recorded seed. The recorded
+* result has to match the game's, and a finished game's time has to be the
+* time of its last move, since that is when the timer stops.
+*/
+void verify(const unsigned char* const data, const std::size_t size,
+            Result& result)
+{
+    ReplayReader reader{data, size};
+    result.header = reader.header();
+    if (result.header.rows * result.header.cols > max_cells)
+        throw BadReplay{"Board too large to verify"};
+
+    Game game{result.header.rows, result.header.cols, result.header.mines,
+              result.header.seed};
+    std::int64_t last_time = 0;
+    while (const auto event = reader.next()) {
+        if (game.is_over())
+            throw BadReplay{"Move after the game ended"};
+        if (event->time < last_time)
+            throw BadReplay{"Move earlier than the one before it"};
+        apply_action(game, event->action, event->row, event->col);
+        last_time = event->time;
+    }
+
+    const ReplayEnd& end = *reader.end();
+    result.won = end.won;
+    result.time = end.time;
+    if (end.won != game.has_won())
+        throw BadReplay{"Recorded result doesn't match the moves"};
+    if (game.is_over() ? end.time != last_time : end.time < last_time)
+        throw BadReplay{"Recorded time doesn't match the moves"};
+    result.bbbv = game.bbbv();
+    result.solved_bbbv = game.solved_bbbv();
+    result.clicks = game.clicks();
+}
+
+// Quotes a CSV field if it needs it
+std::string csv_field(const std::string_view text)
+{
+    if (text.find_first_of(",\"\n") == std::string_view::npos)
+        return std::string{text};
+    std::string quoted{'"'};
+    for (const char c : text) {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    return quoted += '"';
+}
+
+struct Settings {
+    std::vector<std::string> dirs;
+    std::string output;
+    unsigned threads = 0;
+};
+
+const char* const usage =
+    "Usage: termmine-verify [options] <dir>...\n"
+    "  --output <file>  Write the CSV to file instead of stdout\n"
+    "  --threads <n>    Worker threads, 0 for one per core (default 0)\n"
+    "Exits with 2 if any replay is inconsistent.\n";
+
+Settings parse_settings(const int argc, const char* const argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (!arg.starts_with("--")) {
+            settings.dirs.emplace_back(arg);
+            continue;
+        }
+
+        if (++i == argc)
+            throw std::invalid_argument{"missing value for "
+                + std::string{arg}};
+        const std::string_view value{argv[i]};
+        if (arg == "--output") {
+            settings.output = value;
+        } else if (arg == "--threads") {
+            const auto [end, ec] = std::from_chars(
+                value.data(), value.data() + value.size(), settings.threads);
+            if (ec != std::errc{} || end != value.data() + value.size())
+                throw std::invalid_argument{"invalid value for --threads: "
+                    + std::string{value}};
+        } else {
+            throw std::invalid_argument{"unknown option: "
+                + std::string{arg}};
+        }
+    }
+    if (settings.dirs.empty())
+        throw std::invalid_argument{"no directory given"};
+    return settings;
+}
+}
+
+/*
+* Checks every .tmr replay in the given directories by playing its moves back
+* without a terminal, and writes each game's stats as CSV, so submitted times
+* can be trusted.
+*/
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    std::vector<std::string> paths;
+    try {
+        settings = parse_settings(argc, argv);
+        for (const auto& dir : settings.dirs) {
+            for (const auto& entry
+                 : std::filesystem::directory_iterator{dir}) {
+                if (entry.is_regular_file()
+                    && entry.path().extension() == ".tmr")
+                    paths.push_back(entry.path().string());
+            }
+        }
+    } catch (const std::invalid_argument& err) {
+        std::fprintf(stderr, "termmine-verify: %s\n%s", err.what(), usage);
+        return 1;
+    } catch (const std::filesystem::filesystem_error& err) {
+        std::fprintf(stderr, "termmine-verify: %s\n", err.what());
+        return 1;
+    }
+    std::ranges::sort(paths);
+
+    std::FILE* const out = settings.output.empty()
+        ? stdout : std::fopen(settings.output.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "termmine-verify: cannot create %s\n",
+                     settings.output.c_str());
+        return 1;
+    }
+
+    ThreadPool pool{settings.threads};
+    std::vector<Result> results(paths.size());
+    std::atomic<std::size_t> invalid{0};
+    const auto start = std::chrono::steady_clock::now();
+
+    // Contiguous runs of files per task keep the queues short
+    const std::size_t chunks = std::min<std::size_t>(paths.size(),
+                                                     pool.size() * 16);
+    pool.parallel_for(chunks, [&](const std::size_t chunk) {
+        const std::size_t first = paths.size() * chunk / chunks;
+        const std::size_t last = paths.size() * (chunk + 1) / chunks;
+        for (std::size_t i = first; i < last; ++i) {
+            try {
+                const MappedFile file{paths[i].c_str()};
+                verify(file.data(), file.size(), results[i]);
+            } catch (const std::exception& err) {
+                results[i].error = err.what();
+                ++invalid;
+            }
+        }
+    });
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::fputs("file,rows,cols,mines,seed,valid,won,time_ms,3bv,3bv_per_s,"
+               "solved_3bv,clicks,efficiency,error\n", out);
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const Result& result = results[i];
+        std::fprintf(out, "%s,%d,%d,%d,%llu,%d,%d,%lld,%d,",
+                     csv_field(paths[i]).c_str(), result.header.rows,
+                     result.header.cols, result.header.mines,
+                     static_cast<unsigned long long>(result.header.seed),
+                     result.error.empty(), result.won,
+                     static_cast<long long>(result.time), result.bbbv);
+        // Speed and efficiency count the 3BV solved, so lost games have them
+        if (result.error.empty() && result.time > 0)
+            std::fprintf(out, "%.4f",
+                         result.solved_bbbv * 1000.0 / result.time);
+        std::fprintf(out, ",%d,%d,", result.solved_bbbv, result.clicks);
+        if (result.error.empty() && result.clicks > 0)
+            std::fprintf(out, "%.2f",
+                         100.0 * result.solved_bbbv / result.clicks);
+        std::fprintf(out, ",%s\n", csv_field(result.error).c_str());
+    }
+    if (out != stdout)
+        std::fclose(out);
+
+    std::fprintf(stderr, "%zu replays, %zu inconsistent, %.0f replays/s\n",
+                 paths.size(), invalid.load(),
+                 seconds > 0 ? paths.size() / seconds : 0.0);
+    return invalid > 0 ? 2 : 0;
+}